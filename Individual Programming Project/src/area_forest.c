@@ -0,0 +1,149 @@
+/** @file
+ * Implementation of the disjoint-set forest used for tracking the areas of the players.
+ */
+
+#include <stdlib.h>
+
+#include "area_forest.h"
+
+/** Number of labels allocated when the forest is created.
+ */
+#define INITIAL_CAPACITY 64
+
+bool area_forest_init(area_forest* f)
+{
+    f->parent = malloc(INITIAL_CAPACITY * sizeof(uint32_t));
+    f->rank = malloc(INITIAL_CAPACITY * sizeof(uint8_t));
+    f->indexed = malloc(INITIAL_CAPACITY * sizeof(bool));
+    f->size = malloc(INITIAL_CAPACITY * sizeof(uint64_t));
+    f->position = malloc(INITIAL_CAPACITY * sizeof(uint32_t));
+    f->box = malloc(INITIAL_CAPACITY * sizeof(area_box));
+    f->liberties = malloc(INITIAL_CAPACITY * sizeof(uint64_t));
+    if(f->parent == NULL || f->rank == NULL || f->indexed == NULL || f->size == NULL || f->position == NULL ||
+       f->box == NULL || f->liberties == NULL)
+    {
+        area_forest_free(f);
+        return false;
+    }
+    f->capacity = INITIAL_CAPACITY;
+    f->count = 1; // label 0 is NO_AREA
+    f->parent[NO_AREA] = NO_AREA;
+    f->rank[NO_AREA] = 0;
+    f->indexed[NO_AREA] = false;
+    f->size[NO_AREA] = 0;
+    f->position[NO_AREA] = 0;
+    f->box[NO_AREA] = (area_box) {UINT32_MAX, UINT32_MAX, 0, 0};
+    f->liberties[NO_AREA] = 0;
+    return true;
+}
+
+void area_forest_free(area_forest* f)
+{
+    free(f->parent);
+    free(f->rank);
+    free(f->indexed);
+    free(f->size);
+    free(f->position);
+    free(f->box);
+    free(f->liberties);
+    f->parent = NULL;
+    f->rank = NULL;
+    f->indexed = NULL;
+    f->size = NULL;
+    f->position = NULL;
+    f->box = NULL;
+    f->liberties = NULL;
+    f->capacity = 0;
+    f->count = 0;
+}
+
+bool area_forest_reserve(area_forest* f, uint32_t n)
+{
+    if(f->capacity - f->count >= n) return true;
+    if(UINT32_MAX - f->count < n) return false;
+    uint64_t new_capacity = (uint64_t) f->capacity * 2;
+    if(new_capacity < (uint64_t) f->count + n) new_capacity = (uint64_t) f->count + n;
+    if(new_capacity > UINT32_MAX) new_capacity = UINT32_MAX;
+    uint32_t* new_parent = realloc(f->parent, new_capacity * sizeof(uint32_t));
+    if(new_parent == NULL) return false;
+    f->parent = new_parent;
+    uint8_t* new_rank = realloc(f->rank, new_capacity * sizeof(uint8_t));
+    if(new_rank == NULL) return false;
+    f->rank = new_rank;
+    bool* new_indexed = realloc(f->indexed, new_capacity * sizeof(bool));
+    if(new_indexed == NULL) return false;
+    f->indexed = new_indexed;
+    uint64_t* new_size = realloc(f->size, new_capacity * sizeof(uint64_t));
+    if(new_size == NULL) return false;
+    f->size = new_size;
+    uint32_t* new_position = realloc(f->position, new_capacity * sizeof(uint32_t));
+    if(new_position == NULL) return false;
+    f->position = new_position;
+    area_box* new_box = realloc(f->box, new_capacity * sizeof(area_box));
+    if(new_box == NULL) return false;
+    f->box = new_box;
+    uint64_t* new_liberties = realloc(f->liberties, new_capacity * sizeof(uint64_t));
+    if(new_liberties == NULL) return false;
+    f->liberties = new_liberties;
+    f->capacity = new_capacity;
+    return true;
+}
+
+uint32_t area_new(area_forest* f)
+{
+    if(!area_forest_reserve(f, 1)) return NO_AREA;
+    uint32_t label = f->count++;
+    f->parent[label] = label;
+    f->rank[label] = 0;
+    f->indexed[label] = false;
+    f->size[label] = 0;
+    f->position[label] = 0;
+    f->box[label] = (area_box) {UINT32_MAX, UINT32_MAX, 0, 0};
+    f->liberties[label] = 0;
+    return label;
+}
+
+uint32_t area_find(area_forest* f, uint32_t label)
+{
+    uint32_t root = label;
+    while(f->parent[root] != root) root = f->parent[root];
+    while(f->parent[label] != root)
+    {
+        uint32_t next = f->parent[label];
+        f->parent[label] = root;
+        label = next;
+    }
+    return root;
+}
+
+uint32_t area_union(area_forest* f, uint32_t a, uint32_t b)
+{
+    if(a == b) return a;
+    if(f->rank[a] < f->rank[b])
+    {
+        uint32_t temp = a;
+        a = b;
+        b = temp;
+    }
+    f->parent[b] = a;
+    f->size[a] += f->size[b];
+    area_box_join(&f->box[a], &f->box[b]);
+    f->indexed[a] = false;
+    if(f->rank[a] == f->rank[b]) f->rank[a]++;
+    return a;
+}
+
+void area_box_extend(area_box* box, uint32_t x, uint32_t y)
+{
+    if(x < box->min_x) box->min_x = x;
+    if(y < box->min_y) box->min_y = y;
+    if(x > box->max_x) box->max_x = x;
+    if(y > box->max_y) box->max_y = y;
+}
+
+void area_box_join(area_box* box, const area_box* other)
+{
+    if(other->min_x > other->max_x) return;
+    area_box_extend(box, other->min_x, other->min_y);
+    area_box_extend(box, other->max_x, other->max_y);
+}
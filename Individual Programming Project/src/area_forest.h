@@ -0,0 +1,74 @@
+/** @file
+ * Interface of the disjoint-set forest used for tracking the areas of the players.
+ * Every field belonging to a player stores a label, and two fields lie in the same area
+ * if and only if their labels have the same root in the forest.
+ */
+
+#ifndef AREA_FOREST_H
+#define AREA_FOREST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "auxiliary_structs.h"
+
+/** Label stored in the fields which do not belong to any area.
+ */
+#define NO_AREA 0
+
+/** Initializes an empty forest.
+ * @param[out] f - pointer to the initialized forest.
+ * @return true, if the initialization succeeded, and false in case of a memory error.
+ */
+bool area_forest_init(area_forest* f);
+
+/** Frees the memory used by the forest.
+ * @param[in, out] f - pointer to the forest.
+ */
+void area_forest_free(area_forest* f);
+
+/** Makes sure that at least @p n new labels can be created without allocating memory.
+ * @param[in, out] f - pointer to the forest,
+ * @param[in] n - number of labels.
+ * @return true, if there is enough space for @p n labels, and false in case of a memory error.
+ */
+bool area_forest_reserve(area_forest* f, uint32_t n);
+
+/** Creates a new label, being a root of its own one-element tree, not indexed, of an area of size 0
+ * with an empty box and no liberties.
+ * @param[in, out] f - pointer to the forest.
+ * @return The new label, or @ref NO_AREA in case of a memory error.
+ */
+uint32_t area_new(area_forest* f);
+
+/** Finds the root of the tree containing a label, compressing the path on the way.
+ * @param[in, out] f - pointer to the forest,
+ * @param[in] label - a label different from @ref NO_AREA.
+ * @return The root of the tree containing @p label.
+ */
+uint32_t area_find(area_forest* f, uint32_t label);
+
+/** Joins the trees with the given roots, by rank. The joined area is marked as not indexed,
+ * its size is the sum of the sizes of the joined areas, and its box contains both of their boxes.
+ * The number of liberties is not changed, as free fields adjacent to both areas are counted
+ * by both of them, and has to be set by the caller.
+ * @param[in, out] f - pointer to the forest,
+ * @param[in] a - root of the first tree,
+ * @param[in] b - root of the second tree.
+ * @return The root of the joined tree.
+ */
+uint32_t area_union(area_forest* f, uint32_t a, uint32_t b);
+
+/** Extends a box to contain a given field.
+ * @param[in, out] box - pointer to the box,
+ * @param[in] x - the column number of the field,
+ * @param[in] y - the row number of the field.
+ */
+void area_box_extend(area_box* box, uint32_t x, uint32_t y);
+
+/** Extends a box to contain another box.
+ * @param[in, out] box - pointer to the extended box,
+ * @param[in] other - pointer to the other box.
+ */
+void area_box_join(area_box* box, const area_box* other);
+
+#endif // AREA_FOREST_H
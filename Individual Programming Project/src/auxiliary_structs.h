@@ -10,14 +10,174 @@
 #include <stdbool.h>
 
 
-/** Struct that stores a player.
+/** Struct that stores the players of a game, as parallel arrays of records in one allocation,
+ * see @ref player_table.h.
  */
-typedef struct player_s
+typedef struct player_table_s
 {
-    uint64_t occupied_fields; ///< number of fields occupied by the player, non-negative integer
-    uint32_t occupied_areas; ///<  number of areas occupied by the player, non-negative integer
-    bool golden_performed; ///< boolean value informing if the player has performed their golden move
-} player_t;
+    uint64_t* occupied_fields; ///< number of fields occupied by each player
+    uint64_t* frontier_fields; ///< number of free fields adjacent to the fields of each player
+    uint64_t* golden_versions; /**< value of the modification counter of the game increased by one,
+                                    for which golden_possible was computed, or 0, if it never was */
+    uint64_t* fields_capacity; ///< number of indices each of the arrays @p fields has room for
+    uint64_t** fields; ///< indices of the fields occupied by each player, in no particular order
+    uint64_t* areas_capacity; ///< number of roots each of the arrays @p areas has room for
+    uint32_t** areas; ///< roots of the labels of the areas of each player, @p occupied_areas of them
+    uint64_t* golden_performed; ///< bitset of the players who have performed their golden move
+    uint64_t* golden_possible; ///< bitset of the last results of the function @ref gamma_golden_possible
+    uint64_t* liberties_stale; ///< bitset of the players, whose areas have not had their liberties counted since a join
+    uint32_t* occupied_areas; ///< number of areas occupied by each player
+    uint32_t* witness_x; ///< column number of the field, on which the golden move was last found to be possible
+    uint32_t* witness_y; ///< row number of the field, on which the golden move was last found to be possible
+    uint32_t* active_position; ///< position of each player in the array of players occupying any fields
+    void* block; ///< the memory of all the arrays
+    uint64_t count; ///< number of records in use, including the empty record 0
+    uint64_t capacity; ///< number of records the arrays have room for
+    uint32_t* map_players; ///< hash map keys: numbers of the players who have a record, 0 for a free place, or NULL
+    uint32_t* map_records; ///< hash map values: numbers of the records of the players
+    uint64_t map_capacity; ///< number of places in the hash map, a power of two
+} player_table;
+
+/** Struct that stores a rectangle containing all the fields of an area, empty if @p min_x
+ * is bigger than @p max_x.
+ */
+typedef struct area_box_s
+{
+    uint32_t min_x; ///< the smallest column number of a field of the area
+    uint32_t min_y; ///< the smallest row number of a field of the area
+    uint32_t max_x; ///< the biggest column number of a field of the area
+    uint32_t max_y; ///< the biggest row number of a field of the area
+} area_box;
+
+/** Struct that stores a disjoint-set forest of area labels.
+ */
+typedef struct area_forest_s
+{
+    uint32_t* parent; ///< parent of each label, a root is its own parent
+    uint8_t* rank; ///< upper bound of the height of the tree rooted at each label
+    bool* indexed; ///< for each root, true, if the cut fields of its area have been indexed since it last changed
+    uint64_t* size; ///< for each root, number of fields of its area
+    uint32_t* position; ///< for each root, position of the area in the list of the areas of its owner
+    area_box* box; ///< for each root, a rectangle containing its area, possibly bigger than needed after a split
+    uint64_t* liberties; ///< for each root, number of free fields adjacent to its area
+    uint32_t count; ///< number of labels in use
+    uint32_t capacity; ///< number of labels the arrays have room for
+} area_forest;
+
+/** Maximal number of searches run at once when checking if an area has split,
+ * one for every adjacent field.
+ */
+#define MAX_SEARCHES 4
+
+/** @brief Struct that implements a queue of fields, reused by all the searches run by one thread.
+ * Fields are stored as their indices in the arrays indexed like the board. Popped fields stay
+ * in the array before @p first, so the fields reached by a search can be listed after it ends
+ * without a separate list.
+ */
+typedef struct field_queue_s
+{
+    uint64_t* fields; ///< indices of the fields pushed since the queue was last cleared
+    uint64_t first; ///< position of the first field that has not been popped yet
+    uint64_t last; ///< number of the fields pushed since the queue was last cleared
+    uint64_t capacity; ///< number of fields the array @p fields has room for
+} field_queue;
+
+/** Struct that stores one of the searches run at once when checking if an area has split.
+ */
+typedef struct search_s
+{
+    field_queue* pending; ///< fields reached by the search; the ones before its @p first have been expanded
+    unsigned int group; ///< index of a search that has met this one, or its own index
+    uint64_t limit; ///< number of fields of the searched area, which the queue never needs more room than
+} search_t;
+
+/** Struct that stores a field on the stack of the depth-first search indexing the cut fields of an area.
+ */
+typedef struct dfs_frame_s
+{
+    uint64_t field; ///< index of the field
+    uint32_t order; ///< position of the field in the order of visiting, starting from 1
+    unsigned int direction; ///< index of the next neighbour of the field to be checked
+} dfs_frame;
+
+/** Struct that stores the data gathered about a field by the depth-first search
+ * indexing the cut fields of an area.
+ */
+typedef struct dfs_visit_s
+{
+    uint64_t field; ///< index of the field
+    uint32_t low; ///< lowest order of a field reachable from the subtree of the field by one back edge
+    uint8_t children; ///< number of children of the field in the search tree
+    uint8_t separated; ///< number of children, whose subtrees get separated if the field is removed
+} dfs_visit;
+
+/** @brief Struct that stores the scratch memory of the searches and scans of the areas.
+ * It is not a part of any game: every thread has its own one, see @ref workspace.h, taken
+ * by the public functions of the engine and passed to the searches, so it grows to the largest
+ * game played by the thread, and a game carries no scratch memory between the calls.
+ */
+typedef struct workspace_s
+{
+    field_queue searches[MAX_SEARCHES]; ///< queues of the searches checking if an area has split
+    dfs_frame* dfs_stack; ///< stack of the search indexing the cut fields
+    uint64_t dfs_stack_capacity; ///< number of frames the array @p dfs_stack has room for
+    dfs_visit* dfs_visits; ///< fields visited by the search indexing the cut fields
+    uint64_t dfs_visits_capacity; ///< number of fields the array @p dfs_visits has room for
+    uint64_t* rows; /**< bitboards of the parts of an area after a golden move, or wide bitboards
+                         of the fields of a player within the box of an area and of its parts */
+    uint64_t rows_capacity; ///< number of words the array @p rows has room for
+} workspace;
+
+/** Struct that stores an array indexed like the board, split into tiles, see @ref tiled_array.h.
+ */
+typedef struct tiled_array_s
+{
+    void** tiles; ///< pointer to every tile, or to the shared tile of zeros, if it has not been allocated yet
+    void* block; ///< all the tiles allocated at once, or NULL, if they are allocated on the first write
+    bool borrowed; ///< true, if the block is a part of memory owned by someone else, such as a mapped file
+    uint64_t n_of_tiles; ///< number of tiles
+    unsigned int field_bits; ///< number of bits storing one field
+} tiled_array;
+
+/** Struct that stores the header at the beginning of a file written by @ref gamma_new_mapped,
+ * describing the layout of the board following it.
+ */
+typedef struct mapped_header_s
+{
+    char magic[8]; ///< @ref MAPPED_MAGIC, without the terminating zero, identifying the file
+    uint32_t width; ///< board width
+    uint32_t height; ///< board height
+    uint32_t players; ///< number of players
+    uint32_t cell_size; ///< number of bytes storing the owner of one field: 1, 2 or 4
+    uint32_t morton; ///< 1, if the board is stored in the Morton layout, and 0, if row by row
+    uint32_t padding; ///< always 0
+    uint64_t row_stride; ///< difference between the indices of vertically adjacent fields or tiles
+    uint64_t board_offset; ///< position of the board in the file, @ref MAPPED_HEADER_BYTES
+} mapped_header;
+
+/** @brief Struct that stores a stripe of rows of the board, labelled by one thread of @ref gamma_rebuild_areas.
+ * The components of the fields of one player within the stripe are found with local labels,
+ * forming a disjoint-set forest, in which the parent of a label is never bigger than the label.
+ */
+typedef struct labelling_stripe_s
+{
+    struct gamma* g; ///< the game
+    uint32_t first_row; ///< number of the first row of the stripe
+    uint32_t end_row; ///< number of the row following the last row of the stripe
+    uint32_t* parent; ///< parent of each local label, or the label itself for a root; the root, after the labelling
+    uint32_t* owner; ///< number of the player owning the fields of each local label
+    uint64_t* size; ///< for each local root, number of fields of its component
+    area_box* box; ///< for each local root, the smallest rectangle containing its component
+    uint32_t* component; ///< for each local root, number of its component among the components of the stripe
+    uint32_t* row_labels; ///< labels of the fields of the last two rows scanned by a pass, local ones in the first pass
+    uint32_t* edge_labels; ///< local labels of the fields of the first row of the stripe, and then of the last row
+    uint64_t n_of_labels; ///< number of local labels in use, including the unused label 0
+    uint64_t capacity; ///< number of labels the arrays @p parent, @p owner, @p size and @p box have room for
+    uint64_t n_of_components; ///< number of components of the stripe
+    uint64_t offset; ///< number of components of the previous stripes
+    const uint32_t* final_labels; ///< area label of every component of all the stripes, after their merge
+    bool failed; ///< true, if the stripe could not be labelled because of a memory error
+} labelling_stripe;
 
 /** Struct that stores the game state.
  */
@@ -28,29 +188,33 @@ typedef struct gamma
     uint32_t n_of_players; ///< number of players, positive integer
     uint32_t n_of_areas; ///< maximum number of areas, positive integer
     uint64_t free_fields; ///< number of free fields, non-negative integer
-    player_t** arr_of_players; ///< array of players
-    uint32_t** board; ///< array storing the state of the board
-    bool** auxiliary; ///< auxiliary array for executing the BFS algorithm.
+    uint64_t modifications; ///< number of moves and golden moves executed so far
+    player_table players; ///< the players
+    uint64_t row_stride; /**< difference between the indices of vertically adjacent fields, width_x + 1,
+                              or between the indices of vertically adjacent tiles in the Morton layout */
+    int64_t neighbour_offsets[4]; ///< differences between the indices of adjacent fields: left, down, right and up
+    bool sparse; ///< true, if the tiles of the arrays indexed like the board are allocated on the first write
+    void* mapping; ///< memory mapped file storing the arrays indexed like the board, or NULL
+    uint64_t mapping_bytes; ///< length of the mapped file
+    uint64_t board_bytes; ///< length of the header and the board at the beginning of the mapped file
+    tiled_array board; /**< array storing the state of the board row by row, surrounded by a border of fields
+                            owned by nobody, field (x, y) at index (y + 1) * row_stride + x, see @ref new_board,
+                            or tile by tile in the Morton layout, see @ref field_index */
+    unsigned int cell_size; ///< number of bytes storing the owner of one field of the board: 1, 2 or 4
+    uint64_t* player_rows; ///< bitboards of the fields of every player, one after another, if the board is small enough, or NULL
+    tiled_array area_labels; ///< label of the area of every occupied field, indexed like the board
+    area_forest areas; ///< disjoint-set forest joining the labels of the fields lying in one area
+    tiled_array split_parts; ///< number of parts an area splits into, if the field is taken from it; valid if the area is indexed
+    bool lazy_liberties; ///< true, if counting the liberties of joined areas is deferred, see @ref gamma_set_lazy_areas
+    uint32_t n_of_stale; ///< number of the players, whose liberties have not been counted, see @ref resolve_liberties
+    tiled_array occupied_bits; ///< bitset of the occupied fields and of the fields of the border, see @ref mark_border, indexed like the board
+    uint32_t* row_occupied; ///< number of occupied fields in every row, or NULL, if the board is sparse
+    tiled_array field_positions; ///< position of every occupied field in the index of the fields of its owner
+    uint32_t* active_players; ///< numbers of the players occupying at least one field
+    uint32_t n_of_active; ///< number of the players occupying at least one field
+    uint64_t active_capacity; ///< number of players the array @p active_players has room for
 } gamma_t;
 
-/** A list of field coefficient pairs.
- */
-typedef struct field_list_s
-{
-    uint32_t width_x; ///< column number, non-negative integer
-    uint32_t height_y; ///< row number, non-negative integer
-    struct field_list_s* next; /**< pointer to the next list element or null,
-                                    if the given element is the last one.**/
-} field_list;
-
-/** Struct that implements a queue.
- */
-typedef struct queue_s
-{
-    field_list* beginning; ///< pointer to a field_list_s struct which is the beginning of the queue
-    field_list* end; ///< pointer to a field_list_s struct which is the end of the queue
-} queue;
-
 /** Enum for storing the possible commands in batch mode :
  *  move, golden move, function @ref gamma_busy_fields,
  *  function @ref gamma_free_fields, function @ref gamma_golden_possible, function
@@ -69,10 +233,10 @@ typedef struct game_command_s
 } game_command;
 
 /**  Enum for storing the possible commands in interactive mode :
- *  arrows, move skip, game end, regular move, golden move, another key
- *  which is not a command.
+ *  arrows, jump to the next free field, move skip, game end, regular move, golden move,
+ *  another key which is not a command.
  */
-enum key{up, down, left, right, skip, end, spacebar, golden_g, other};
+enum key{up, down, left, right, tab, skip, end, spacebar, golden_g, other};
 
 /** Struct that stores the coefficients of the virtual cursor (according to the board, and not the terminal)
  * as well as the key data necessary for determining the coefficients in the terminal based on them.
@@ -0,0 +1,142 @@
+/** @file
+ * Implementation of the operations on bitboards.
+ */
+
+#include <stdbool.h>
+
+#include "bitboard.h"
+
+/** Compiles a function also for the vector instructions of newer processors, if the compiler
+ * can choose the variant matching the processor when the program starts.
+ */
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define VECTOR_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define VECTOR_CLONES
+#endif
+
+/** Extends the fields of one row along the runs of the mask containing them, in both directions,
+ * in six steps doubling the distance covered each time.
+ * @param[in] seed - fields of the row, contained in @p mask,
+ * @param[in] mask - fields of the row, through which the seed may grow.
+ * @return The fields of the runs of @p mask containing a field of @p seed.
+ */
+static uint64_t fill_row(uint64_t seed, uint64_t mask)
+{
+    uint64_t left = seed, right = seed;
+    uint64_t left_open = mask, right_open = mask;
+    for(unsigned int shift = 1; shift < BITBOARD_WIDTH; shift *= 2)
+    {
+        left |= left_open & (left << shift);
+        left_open &= left_open << shift;
+        right |= right_open & (right >> shift);
+        right_open &= right_open >> shift;
+    }
+    return left | right;
+}
+
+void bitboard_flood(const uint64_t* mask, uint64_t* part, uint32_t height)
+{
+    bool changed = true;
+    while(changed)
+    {
+        changed = false;
+        for(uint32_t y = 0; y < height; y++)
+        {
+            uint64_t seed = part[y];
+            if(y != 0) seed |= part[y-1] & mask[y];
+            uint64_t grown = fill_row(seed, mask[y]);
+            changed |= grown != part[y];
+            part[y] = grown;
+        }
+        for(uint32_t y = height - 1; y > 0; y--)
+        {
+            uint64_t grown = fill_row(part[y-1] | (part[y] & mask[y-1]), mask[y-1]);
+            changed |= grown != part[y-1];
+            part[y-1] = grown;
+        }
+    }
+}
+
+/** Adds to the fields of one row of a wide bitboard the fields of an adjacent row, which lie in the mask.
+ * @param[in, out] row - fields of the row,
+ * @param[in] adjacent - fields of the adjacent row,
+ * @param[in] mask - fields of the row, through which the set may grow,
+ * @param[in] words - number of words of the row.
+ * @return True, if any field has been added, and false otherwise.
+ */
+static inline __attribute__((always_inline))
+bool seed_wide_row(uint64_t* row, const uint64_t* adjacent, const uint64_t* mask, uint32_t words)
+{
+    uint64_t added = 0;
+    for(uint32_t w = 0; w < words; w++)
+    {
+        uint64_t seeded = row[w] | (adjacent[w] & mask[w]);
+        added |= seeded ^ row[w];
+        row[w] = seeded;
+    }
+    return added != 0;
+}
+
+/** Extends the fields of one row of a wide bitboard along the runs of the mask containing them.
+ * @param[in, out] row - fields of the row, contained in @p mask,
+ * @param[in] mask - fields of the row, through which the set may grow,
+ * @param[in] words - number of words of the row.
+ * @return True, if any field has been added, and false otherwise.
+ */
+static inline __attribute__((always_inline))
+bool fill_wide_row(uint64_t* row, const uint64_t* mask, uint32_t words)
+{
+    uint64_t added = 0, carry = 0;
+    for(uint32_t w = 0; w < words; w++)
+    {
+        uint64_t grown = fill_row(row[w] | (carry & mask[w]), mask[w]);
+        added |= grown ^ row[w];
+        row[w] = grown;
+        carry = grown >> (BITBOARD_WIDTH - 1);
+    }
+    carry = 0;
+    for(uint32_t w = words; w-- > 0;)
+    {
+        uint64_t grown = fill_row(row[w] | (carry & mask[w]), mask[w]);
+        added |= grown ^ row[w];
+        row[w] = grown;
+        carry = grown << (BITBOARD_WIDTH - 1);
+    }
+    return added != 0;
+}
+
+VECTOR_CLONES
+bool wide_bitboard_flood(const uint64_t* mask, uint64_t* part, uint32_t words, uint32_t height,
+                         uint32_t* sweeps)
+{
+    bool changed = true;
+    while(changed)
+    {
+        if(*sweeps == 0) return false;
+        (*sweeps)--;
+        changed = false;
+        for(uint32_t y = 0; y < height; y++)
+        {
+            uint64_t* row = part + (uint64_t) y * words;
+            const uint64_t* row_mask = mask + (uint64_t) y * words;
+            if(y != 0) changed |= seed_wide_row(row, row - words, row_mask, words);
+            changed |= fill_wide_row(row, row_mask, words);
+        }
+        for(uint32_t y = height - 1; y > 0; y--)
+        {
+            uint64_t* row = part + (uint64_t) (y - 1) * words;
+            const uint64_t* row_mask = mask + (uint64_t) (y - 1) * words;
+            changed |= seed_wide_row(row, row + words, row_mask, words);
+            changed |= fill_wide_row(row, row_mask, words);
+        }
+    }
+    return true;
+}
+
+uint64_t bitboard_count(const uint64_t* rows, uint64_t n)
+{
+    uint64_t count = 0;
+    for(uint64_t k = 0; k < n; k++) count += __builtin_popcountll(rows[k]);
+    return count;
+}
@@ -0,0 +1,53 @@
+/** @file
+ * Interface of the operations on bitboards. A bitboard is a set of fields of a board at most
+ * @ref BITBOARD_WIDTH fields wide, stored as one word per row, in which bit x stands for
+ * the field in column x. A wide bitboard stores a set of fields of a wider rectangle
+ * in several words per row, in which bit x % 64 of word x / 64 stands for the field in column x.
+ */
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/** Maximal width of a board, whose sets of fields can be stored as bitboards.
+ */
+#define BITBOARD_WIDTH 64
+
+/** @brief Extends a set of fields to all the fields connected to it within a mask.
+ * Every row is extended at once, by shifts and conjunctions, along the runs of the mask
+ * containing the fields of the set, and then by the fields of the adjacent rows. The rows
+ * are swept downwards and upwards, until the set stops growing.
+ * @param[in] mask - bitboard of the fields, through which the set may grow,
+ * @param[in, out] part - bitboard of the set, contained in @p mask,
+ * @param[in] height - number of rows of both bitboards, positive integer.
+ */
+void bitboard_flood(const uint64_t* mask, uint64_t* part, uint32_t height);
+
+/** @brief Extends a set of fields to all the fields connected to it within a mask, like
+ * @ref bitboard_flood, but for wide bitboards. Every row is extended word by word,
+ * carrying the fields across the borders of the words, once from left to right and once
+ * from right to left. Where the processor supports wider vector instructions, a variant
+ * of the function using them is chosen when the program starts.
+ * Every sweep down and up the rows reads the whole bitboard, and a winding set needs one sweep
+ * per turn of its path, so the flood stops after a given number of sweeps.
+ * @param[in] mask - wide bitboard of the fields, through which the set may grow,
+ * @param[in, out] part - wide bitboard of the set, contained in @p mask,
+ * @param[in] words - number of words of every row of both bitboards, positive integer,
+ * @param[in] height - number of rows of both bitboards, positive integer,
+ * @param[in, out] sweeps - number of sweeps the flood may make, decreased by the sweeps made.
+ * @return True, if the set has been extended to all the connected fields, and false, if
+ *         the flood has run out of the sweeps, leaving the set partly extended.
+ */
+bool wide_bitboard_flood(const uint64_t* mask, uint64_t* part, uint32_t words, uint32_t height,
+                         uint32_t* sweeps);
+
+/** Counts the fields of a bitboard, or of a wide bitboard.
+ * @param[in] rows - the bitboard,
+ * @param[in] n - number of words of the bitboard.
+ * @return The number of fields of the bitboard.
+ */
+uint64_t bitboard_count(const uint64_t* rows, uint64_t n);
+
+#endif // BITBOARD_H
@@ -2,48 +2,163 @@
  * IMplementation of the gamma game engine.
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
 
 #include "gamma.h"
 #include "auxiliary_structs.h"
+#include "area_forest.h"
+#include "bitboard.h"
+#include "tiled_array.h"
+#include "player_table.h"
+#include "workspace.h"
+
+
+/** @brief Calls a function specialized for the number of bytes storing one field of the board.
+ * The function is called with the additional last argument equal to @p cell_size of @p g,
+ * but given as a constant in each of the three calls, so that each of them is compiled separately,
+ * with every access to the board resolved in advance. Used for the searches, which read
+ * the board in a loop; the function should be declared always_inline.
+ */
+#define WITH_CELL_SIZE(g, function, ...) \
+    ((g)->cell_size == sizeof(uint8_t) ? function(__VA_ARGS__, sizeof(uint8_t)) : \
+     (g)->cell_size == sizeof(uint16_t) ? function(__VA_ARGS__, sizeof(uint16_t)) : \
+     function(__VA_ARGS__, sizeof(uint32_t)))
+
+/** Maximal number of players, for whom the fields are also stored as bitboards,
+ * if the board is at most @ref BITBOARD_WIDTH fields wide and high.
+ */
+#define BITBOARD_MAX_PLAYERS 64
+
+/** Label marking the fields reached by the search no. @p i of @ref split_search.
+ * These labels are created together with the forest and never belong to any area.
+ */
+#define SEARCH_LABEL(i) (NO_AREA + 1 + (i))
+
+/** Value returned by @ref split_search, if it has been abandoned for @ref mask_split,
+ * and by @ref mask_split, if it has been abandoned for @ref split_search without a limit.
+ */
+#define SPLIT_ABANDONED (MAX_SEARCHES + 1)
+
+/** Minimal number of fields of the box of an area, for which @ref split_search may be abandoned
+ * for @ref mask_split.
+ */
+#define MASK_SPLIT_MIN_FIELDS ((uint64_t) 1 << 12)
+
+/** Number of fields of the box of an area per one field, which @ref split_search may expand
+ * before it is abandoned for @ref mask_split, which reads every field of the box once.
+ */
+#define MASK_SPLIT_RATIO 16
+
+/** Maximal number of sweeps of all the floods of one @ref mask_split, each reading every field
+ * of the box. The parts of a compact area are flooded in a few sweeps, while a winding one
+ * would need a sweep per turn, costing more than searching the whole area.
+ */
+#define MASK_SPLIT_SWEEPS 16
+
+/** Text identifying the files written by @ref gamma_new_mapped, stored at their beginning.
+ */
+#define MAPPED_MAGIC "GAMMAMAP"
+
+/** Number of bytes before the board in a file written by @ref gamma_new_mapped: the header,
+ * see @ref mapped_header, padded to a page, so that the arrays stay aligned.
+ */
+#define MAPPED_HEADER_BYTES 4096
+
+/** Maximal number of threads labelling the stripes of the board in @ref gamma_rebuild_areas.
+ */
+#define MAX_LABELLING_THREADS 64
+
+/** Minimal number of fields of a stripe labelled by one thread in @ref gamma_rebuild_areas.
+ */
+#define MIN_STRIPE_FIELDS ((uint64_t) 1 << 16)
+
+/** Value of @ref split_part marking the fields visited by the search of @ref index_area_cells,
+ * before their numbers of parts are written.
+ */
+#define DFS_VISITED UINT8_MAX
+
+
+
+/** Makes sure a queue has room for a given number of fields, so that a search filling it
+ * does not have to allocate any memory.
+ * @param[in, out] q - the address of the queue,
+ * @param[in] size - the required number of fields.
+ * @return True, if there is enough room, and false in case of a memory error.
+ */
+static bool reserve_queue(field_queue* q, uint64_t size)
+{
+    if(size <= q->capacity) return true;
+    uint64_t new_capacity = 2 * q->capacity < size ? size : 2 * q->capacity;
+    uint64_t* new_fields = realloc(q->fields, new_capacity * sizeof(uint64_t));
+    if(new_fields == NULL) return false;
+    q->fields = new_fields;
+    q->capacity = new_capacity;
+    return true;
+}
 
+/** Makes sure a queue has room for one more field, doubling its size, but not beyond
+ * the number of fields it may ever hold, so the queues of all the searches of one area
+ * together have room for at most about twice as many fields as they have reached.
+ * @param[in, out] q - the address of the queue,
+ * @param[in] limit - number of fields the queue may ever hold.
+ * @return True, if there is room for one more field, and false in case of a memory error.
+ */
+static bool queue_grow(field_queue* q, uint64_t limit)
+{
+    if(q->last < q->capacity) return true;
+    uint64_t new_capacity = q->capacity == 0 ? 64 : 2 * q->capacity;
+    if(new_capacity > limit) new_capacity = limit;
+    if(new_capacity <= q->last) new_capacity = q->last + 1;
+    uint64_t* new_fields = realloc(q->fields, new_capacity * sizeof(uint64_t));
+    if(new_fields == NULL) return false;
+    q->fields = new_fields;
+    q->capacity = new_capacity;
+    return true;
+}
 
-/** Initializes a queue..
- * @param [in, out] q - pointer to the pointer, which is to point to the initialized queue.
+/** Makes sure the bitboards of a workspace have room for a given number of words.
+ * @param[in, out] w - pointer to the workspace,
+ * @param[in] n_of_words - the required number of words.
+ * @return True, if there is enough room, and false in case of a memory error.
  */
-static void queue_init(queue** q)
+static bool reserve_rows(workspace* w, uint64_t n_of_words)
 {
-    *q = malloc(sizeof(queue));
-    (*q)->beginning = NULL;
+    if(n_of_words <= w->rows_capacity) return true;
+    if(n_of_words > SIZE_MAX / sizeof(uint64_t)) return false;
+    uint64_t* new_rows = realloc(w->rows, n_of_words * sizeof(uint64_t));
+    if(new_rows == NULL) return false;
+    w->rows = new_rows;
+    w->rows_capacity = n_of_words;
+    return true;
 }
 
+/** Empties a queue, keeping its memory for the next search.
+ * @param[out] q - the address of the queue.
+ */
+static void queue_clear(field_queue* q)
+{
+    q->first = 0;
+    q->last = 0;
+}
 
-/** @brief Inserts a field intwo the queue.
- * Inserts into the queue a pair of coefficients new_width, new_height.
+/** Inserts a field into the queue. Requires room for it, see @ref reserve_queue and @ref queue_grow.
  * @param[in, out] q - the address of the queue,
- * @param[in] new_width - inserted column number, positive integer,
- * @param[in] new_height - inserted row number, positive integer
+ * @param[in] field - index of the inserted field.
  */
-static void queue_push(queue* q, uint32_t new_width, uint32_t new_height)
+static void queue_push(field_queue* q, uint64_t field)
 {
-    field_list* new_field = malloc(sizeof(field_list));
-    new_field->next = NULL;
-    new_field->width_x = new_width;
-    new_field->height_y = new_height;
-    if(q->beginning == NULL)
-    {
-        q->beginning = new_field;
-        q->end = new_field;
-    }
-    else
-    {
-        q->end->next = new_field;
-        q->end = q->end->next;
-    }
+    q->fields[q->last++] = field;
 }
 
 /** Checks if the queue is empty.
@@ -51,505 +166,2512 @@ static void queue_push(queue* q, uint32_t new_width, uint32_t new_height)
  * @return True, if the queue is empty, and false 
  *         otherwise.
  */
-static bool queue_empty(queue* q)
+static bool queue_empty(field_queue* q)
+{
+    return q->first == q->last;
+}
+
+/** Pops the first element of the queue, which must not be empty.
+ * @param[in, out] q - the address of the queue.
+ * @return The index of the popped field.
+ */
+static uint64_t queue_pop(field_queue* q)
+{
+    return q->fields[q->first++];
+}
+
+/** Estimates the number of bytes of memory that a game can use without tiles allocated on
+ * the first write, as a quarter of the physical memory.
+ * @return The number of bytes.
+ */
+static uint64_t dense_memory_limit(void)
+{
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long page_size = sysconf(_SC_PAGE_SIZE);
+    if(pages <= 0 || page_size <= 0) return (uint64_t) 1 << 30;
+    return (uint64_t) pages * page_size / 4;
+}
+
+/** Sets the number of bytes storing the owner of one field of the board to the smallest number
+ * of bytes enough for every player number.
+ * @param[in, out] g - pointer to the struct storing the game state, with the number of players set.
+ */
+static void choose_cell_size(gamma_t* g)
+{
+    if(g->n_of_players <= UINT8_MAX) g->cell_size = sizeof(uint8_t);
+    else if(g->n_of_players <= UINT16_MAX) g->cell_size = sizeof(uint16_t);
+    else g->cell_size = sizeof(uint32_t);
+}
+
+/** @brief Creates a new board.
+ * The board is an array of fields stored row by row, all of them free at first. The fields of the
+ * game are surrounded by a border of fields, which are never written to, so they stay empty
+ * and never belong to any player. The rows of the border above and below the board are whole rows,
+ * and a single column of the border at the end of every row is at the same time the left border
+ * of the next row. Thus every field of the game has four adjacent fields in the array.
+ * The fields of the border are marked as occupied in the bitset of the occupied fields, see @ref mark_border.
+ * In the Morton layout the board with the border is stored in tiles, see @ref field_index,
+ * and the fields of the last tiles beyond the border are never written to either.
+ * The owner of each field is stored in the smallest number of bytes enough for every player number.
+ * @param[in, out] g - pointer to the struct storing the game state, with the number of players set,
+ * @param[in] size - number of fields of the array, including the border.
+ * @return True, if the board has been created, and false in case of a memory error.
+ */
+static bool new_board(gamma_t* g, uint64_t size)
+{
+    choose_cell_size(g);
+    return tiled_array_init(&g->board, size, 8 * g->cell_size, g->sparse);
+}
+
+/** @brief Creates the arrays indexed like the board, with all the fields free.
+ * If they would take more than @ref dense_memory_limit, or allocating them at once fails,
+ * the board is sparse: the tiles of the arrays are allocated only when a field of a tile
+ * is taken, so a huge board with a few moves uses little memory.
+ * @param[in, out] g - pointer to the struct storing the game state, with the board dimensions
+ *                     and the number of players set,
+ * @param[in] size - number of fields of each of the arrays, including the border.
+ * @return True, if the arrays have been created, and false in case of a memory error.
+ */
+static bool new_field_arrays(gamma_t* g, uint64_t size)
+{
+    uint64_t bytes_per_field = 14; // owner, label, split parts, position and a bit, at most
+    g->sparse = size > dense_memory_limit() / bytes_per_field;
+    for(;;)
+    {
+        if(new_board(g, size) &&
+           tiled_array_init(&g->area_labels, size, 32, g->sparse) &&
+           tiled_array_init(&g->split_parts, size, 8, g->sparse) &&
+           tiled_array_init(&g->field_positions, size, 32, g->sparse) &&
+           tiled_array_init(&g->occupied_bits, size, 1, g->sparse))
+        {
+            if(g->sparse) return true;
+            g->row_occupied = calloc(g->height_y, sizeof(uint32_t));
+            if(g->row_occupied != NULL) return true;
+        }
+        tiled_array_free(&g->board);
+        tiled_array_free(&g->area_labels);
+        tiled_array_free(&g->split_parts);
+        tiled_array_free(&g->field_positions);
+        tiled_array_free(&g->occupied_bits);
+        if(g->sparse) return false;
+        g->sparse = true;
+    }
+}
+
+/** Opens the file of @ref map_field_arrays, making sure it is not a file of some other kind:
+ * an existing file is overwritten only if it is empty or begins with @ref MAPPED_MAGIC.
+ * @param[in] path - path of the file.
+ * @return The file descriptor, or -1, if the file cannot be opened or must not be overwritten.
+ */
+static int open_mapped_file(const char* path)
 {
-    return (q->beginning == NULL);
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if(fd < 0) return -1;
+    struct stat st;
+    char magic[sizeof(MAPPED_MAGIC) - 1];
+    if(fstat(fd, &st) != 0 ||
+       (st.st_size != 0 && (pread(fd, magic, sizeof(magic), 0) != sizeof(magic) ||
+                            memcmp(magic, MAPPED_MAGIC, sizeof(magic)) != 0)) ||
+       ftruncate(fd, 0) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
 }
 
-/** Pops the first element of the queue.
- * If it is empty, return NULL.
- * @param[in] q - the address of the queue.
- * @return pointer to the struct field_list containing the first queue element,
- * or NULL, if it is empty.
+/** Writes the header of a mapped file, see @ref mapped_header.
+ * @param[in] g - pointer to the struct storing the game state, with the board created,
+ * @param[out] header - the beginning of the mapped file.
  */
-static field_list* queue_pop(queue* q)
+static void write_mapped_header(gamma_t* g, mapped_header* header)
 {
-    if (queue_empty(q)) return NULL;
-    field_list* aux = q->beginning;
-    q->beginning = aux->next;
-    aux->next = NULL;
-    return aux;
+    memcpy(header->magic, MAPPED_MAGIC, sizeof(header->magic));
+    header->width = g->width_x;
+    header->height = g->height_y;
+    header->players = g->n_of_players;
+    header->cell_size = g->cell_size;
+#ifdef MORTON_LAYOUT
+    header->morton = 1;
+#else
+    header->morton = 0;
+#endif
+    header->padding = 0;
+    header->row_stride = g->row_stride;
+    header->board_offset = MAPPED_HEADER_BYTES;
 }
 
-/** Clears the queue.
- * @param[in] q - the address of the queue.
+/** @brief Creates the arrays indexed like the board in a memory mapped file.
+ * The file begins with a header describing the board, see @ref mapped_header, and the board
+ * follows it at @ref MAPPED_HEADER_BYTES, followed by the other arrays in the order of @ref reserve_field.
+ * The file is extended to its length without writing, so it reads as zeros, like a new board,
+ * and takes disk space only as the fields are written. Moves and searches touch the fields
+ * in no particular order, so the kernel is advised not to read ahead, apart from
+ * the scans of the whole board, see @ref advise_board.
+ * @param[in, out] g - pointer to the struct storing the game state, with the board dimensions
+ *                     and the number of players set,
+ * @param[in] size - number of fields of each of the arrays, including the border,
+ * @param[in] path - path of the file, which is created or overwritten, see @ref open_mapped_file.
+ * @return True, if the arrays have been created, and false in case of an error.
  */
-static void queue_clear(queue** q)
+static bool map_field_arrays(gamma_t* g, uint64_t size, const char* path)
 {
-    while(!queue_empty(*q))
+    choose_cell_size(g);
+    tiled_array* arrays[] = {&g->board, &g->area_labels, &g->split_parts,
+                             &g->field_positions, &g->occupied_bits};
+    unsigned int field_bits[] = {8 * g->cell_size, 32, 8, 32, 1};
+    uint64_t offsets[5];
+    uint64_t bytes = MAPPED_HEADER_BYTES;
+    for(unsigned int k = 0; k < 5; k++)
+    {
+        uint64_t array_bytes = tiled_array_bytes(size, field_bits[k]);
+        if(array_bytes == 0 || array_bytes > INT64_MAX - bytes) return false;
+        offsets[k] = bytes;
+        bytes += array_bytes;
+    }
+    int fd = open_mapped_file(path);
+    if(fd < 0) return false;
+    if(ftruncate(fd, (off_t) bytes) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    void* mapping = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mapping == MAP_FAILED) return false;
+    g->mapping = mapping;
+    g->mapping_bytes = bytes;
+    g->board_bytes = offsets[1];
+    write_mapped_header(g, mapping);
+    posix_madvise(mapping, bytes, POSIX_MADV_RANDOM);
+    for(unsigned int k = 0; k < 5; k++)
     {
-        field_list* aux = queue_pop(*q);
-        free(aux);
+        if(!tiled_array_init_in(arrays[k], size, field_bits[k], (uint8_t*) mapping + offsets[k])) return false;
     }
-    free(*q);
-    *q = NULL;
+    g->row_occupied = calloc(g->height_y, sizeof(uint32_t));
+    return g->row_occupied != NULL;
+}
+
+/** Advises the kernel how the board is going to be read, if it is stored in a memory mapped file.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] advice - POSIX_MADV_SEQUENTIAL before a scan of the whole board in the order of the indices,
+ *                     or POSIX_MADV_RANDOM after it.
+ */
+static void advise_board(gamma_t* g, int advice)
+{
+    if(g->mapping != NULL) posix_madvise(g->mapping, g->board_bytes, advice);
+}
+
+/** Returns the tile of the board containing a given field, see @ref read_cell.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field.
+ * @return Pointer to the tile.
+ */
+static void* board_tile(gamma_t* g, uint64_t i)
+{
+    return g->board.tiles[i >> TILE_SHIFT];
+}
+
+/** Returns the area label of a field.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field.
+ * @return Pointer to the label, which may be written to only if the field has been reserved
+ *         by @ref reserve_field.
+ */
+static uint32_t* area_label(gamma_t* g, uint64_t i)
+{
+    return (uint32_t*) g->area_labels.tiles[i >> TILE_SHIFT] + (i & TILE_MASK);
+}
+
+/** Returns the number of parts the area of a field splits into, if the field is taken from it.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field.
+ * @return Pointer to the number, see @ref area_label.
+ */
+static uint8_t* split_part(gamma_t* g, uint64_t i)
+{
+    return (uint8_t*) g->split_parts.tiles[i >> TILE_SHIFT] + (i & TILE_MASK);
+}
+
+/** Returns the position of a field in the index of the fields of its owner.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field.
+ * @return Pointer to the position, see @ref area_label.
+ */
+static uint32_t* field_position(gamma_t* g, uint64_t i)
+{
+    return (uint32_t*) g->field_positions.tiles[i >> TILE_SHIFT] + (i & TILE_MASK);
+}
+
+/** Returns the word of a bitset indexed like the board, which contains the bit of a given field.
+ * @param[in] bits - the bitset,
+ * @param[in] i - index of the field.
+ * @return Pointer to the word, see @ref area_label.
+ */
+static uint64_t* bitset_word(tiled_array* bits, uint64_t i)
+{
+    return (uint64_t*) bits->tiles[i >> TILE_SHIFT] + (i & TILE_MASK) / 64;
+}
+
+/** Sets the bit of a field in the bitset of the occupied fields.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field or of a field of the border, in an allocated tile of the bitset.
+ */
+static void mark_occupied(gamma_t* g, uint64_t i)
+{
+    *bitset_word(&g->occupied_bits, i) |= (uint64_t) 1 << (i % 64);
 }
 
-/** Creates a new array of players.
- * @param[in] players - array size (number of players), positive integer.
- * @return pointer to the allocated array.
+#ifndef MORTON_LAYOUT
+
+/** Sets the bits of a range of fields in the bitset of the occupied fields, a word at once.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] begin - the first index of the range,
+ * @param[in] end - the index after the range, in the arrays.
  */
-static player_t** new_arr_of_players(uint32_t players)
+static void mark_occupied_range(gamma_t* g, uint64_t begin, uint64_t end)
 {
-    player_t** new_arr = malloc(players*sizeof(player_t*));
-    if(new_arr == NULL) return NULL;
-    for(uint32_t i = 0; i < players; i++)
+    while(begin < end)
     {
-        player_t* current = malloc(sizeof(player_t));
-        if (current == NULL)
+        uint64_t bits = UINT64_MAX << (begin % 64);
+        uint64_t next = (begin / 64 + 1) * 64;
+        if(next > end)
         {
-            for(uint32_t j = 0; j < i; j++) free(new_arr[j]);
-            free(new_arr);
-            return NULL;
+            bits &= UINT64_MAX >> (next - end);
+            next = end;
         }
-        current->golden_performed = false;
-        current->occupied_areas = 0;
-        current->occupied_fields = 0;
-        new_arr[i] = current;
+        *bitset_word(&g->occupied_bits, begin) |= bits;
+        begin = next;
     }
-    return new_arr;
 }
 
-/** @brief Creates a new board.
- * @param[in] width - number of columns, positive integer,
- * @param[in] height - number of rowsy, positive integer.
- * @return The pointer to the allocated board.
+#endif
+
+/** Reads the owner of a field from a board storing every field in a given number of bytes.
+ * When @p cell_size is a constant, this is a single read of the right size.
+ * @param[in] board - the board,
+ * @param[in] cell_size - number of bytes storing one field: 1, 2 or 4,
+ * @param[in] i - index of the field.
+ * @return The number of the owner of the field, or 0, if it is free.
+ */
+static inline uint32_t read_cell(const void* board, unsigned int cell_size, uint64_t i)
+{
+    switch(cell_size)
+    {
+        case sizeof(uint8_t):
+            return ((const uint8_t*) board)[i];
+        case sizeof(uint16_t):
+            return ((const uint16_t*) board)[i];
+        default:
+            return ((const uint32_t*) board)[i];
+    }
+}
+
+/** Writes the owner of a field into a board storing every field in a given number of bytes.
+ * @param[in, out] board - the board,
+ * @param[in] cell_size - number of bytes storing one field: 1, 2 or 4,
+ * @param[in] i - index of the field,
+ * @param[in] owner - number of the owner of the field, or 0, if it is free.
+ */
+static inline void write_cell(void* board, unsigned int cell_size, uint64_t i, uint32_t owner)
+{
+    switch(cell_size)
+    {
+        case sizeof(uint8_t):
+            ((uint8_t*) board)[i] = owner;
+            break;
+        case sizeof(uint16_t):
+            ((uint16_t*) board)[i] = owner;
+            break;
+        default:
+            ((uint32_t*) board)[i] = owner;
+    }
+}
+
+#ifdef MORTON_LAYOUT
+
+/** Bits of the index of a field within its tile which store its column number.
+ */
+#define MORTON_X_BITS 0x15
+
+/** Bits of the index of a field within its tile which store its row number.
+ */
+#define MORTON_Y_BITS 0x2A
+
+/** Spreads the three bits of a coordinate within a tile onto every second bit.
+ * @param[in] v - the coordinate, integer from 0 to 7.
+ * @return The bits of @p v at positions 0, 2 and 4.
+ */
+static uint64_t dilate(uint64_t v)
+{
+    return (v & 1) | ((v & 2) << 1) | ((v & 4) << 2);
+}
+
+/** Reverses @ref dilate.
+ * @param[in] m - the bits at positions 0, 2 and 4, other bits being zeros.
+ * @return The coordinate, integer from 0 to 7.
+ */
+static uint64_t compact(uint64_t m)
+{
+    return (m & 1) | ((m >> 1) & 2) | ((m >> 2) & 4);
+}
+
+/** Returns the index of the field ( @p x, @p y) in the flat arrays
+ * storing the state of the fields. The board together with its border is divided into tiles
+ * of 8 x 8 fields, stored row by row, and the fields within a tile are stored in Morton order,
+ * so that the bits of the column and row numbers interleave in the index.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] x - the column number, non-negative integer smaller than the value of @p width
+                  from the function @ref gamma_new,
+ * @param[in] y - the row number, non-negative integer smaller than the value of @p height
+                  from the function @ref gamma_new.
+ * @return The index of the field.
+ */
+static uint64_t field_index(gamma_t* g, uint32_t x, uint32_t y)
+{
+    uint64_t column = (uint64_t) x + 1;
+    uint64_t row = (uint64_t) y + 1;
+    return (row >> 3) * g->row_stride + ((column >> 3) << 6) + (dilate(column & 7) | (dilate(row & 7) << 1));
+}
+
+/** Returns the column number after the last field of a row, which lies in the same tile
+ * of the arrays indexed like the board as a given field. Along a row the tiles of 8 x 8 fields
+ * follow one another, so the tiles of the arrays, each of them being a run of these, do too.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] x - the column number of the field,
+ * @param[in] y - the row number of the field.
+ * @return The column number, not bigger than the value of @p width from the function @ref gamma_new.
+ */
+static uint32_t tile_run_end(gamma_t* g, uint32_t x, uint32_t y)
+{
+    uint64_t first_tile = (((uint64_t) y + 1) >> 3) * (g->row_stride >> 6);
+    uint64_t end_tile = ((first_tile + (((uint64_t) x + 1) >> 3)) | (TILE_MASK >> 6)) + 1;
+    uint64_t end = ((end_tile - first_tile) << 3) - 1;
+    return end < g->width_x ? (uint32_t) end : g->width_x;
+}
+
+/** Computes the coefficients of a field from its index, counting the border as column
+ * and row number 0.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field or of a field of the border,
+ * @param[out] column - the column number increased by one,
+ * @param[out] row - the row number increased by one.
+ */
+static void padded_coordinates(gamma_t* g, uint64_t i, uint64_t* column, uint64_t* row)
+{
+    *column = ((i % g->row_stride) >> 6 << 3) + compact(i & MORTON_X_BITS);
+    *row = (i / g->row_stride << 3) + compact((i >> 1) & MORTON_X_BITS);
+}
+
+/** Computes the coefficients of a field from its index in the flat arrays
+ * storing the state of the fields.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of a field of the board, not of the border,
+ * @param[out] x - the column number of the field,
+ * @param[out] y - the row number of the field.
+ */
+static void field_coordinates(gamma_t* g, uint64_t i, uint32_t* x, uint32_t* y)
+{
+    uint64_t column, row;
+    padded_coordinates(g, i, &column, &row);
+    *x = column - 1;
+    *y = row - 1;
+}
+
+/** Checks if a field belongs to the board, and not to the border surrounding it
+ * or to the part of the last tiles beyond the border.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field or of a field of the border.
+ * @return True, if the field belongs to the board, and false otherwise.
+ */
+static bool on_board(gamma_t* g, uint64_t i)
+{
+    uint64_t column, row;
+    padded_coordinates(g, i, &column, &row);
+    return column != 0 && column <= g->width_x && row != 0 && row <= g->height_y;
+}
+
+/** Marks the fields of the border within a range of indices as occupied, see @ref is_liberty.
+ * Only the tiles of 8 x 8 fields at the edges of the board contain fields of the border,
+ * so the other tiles are skipped after checking their coordinates.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] begin - the first index of the range, a multiple of 64,
+ * @param[in] end - the index after the range, which may lie beyond the arrays.
+ */
+static void mark_border(gamma_t* g, uint64_t begin, uint64_t end)
+{
+    uint64_t tiles_per_row = g->row_stride >> 6;
+    uint64_t size = (((uint64_t) g->height_y + 9) >> 3) * g->row_stride;
+    if(end > size) end = size;
+    uint64_t tile_row = (begin >> 6) / tiles_per_row;
+    uint64_t tile_column = (begin >> 6) % tiles_per_row;
+    for(uint64_t tile = begin; tile < end; tile += 64)
+    {
+        if(tile_row == 0 || tile_column == 0 ||
+           (tile_row << 3) + 7 > g->height_y || (tile_column << 3) + 7 > g->width_x)
+        {
+            for(uint64_t i = tile; i < tile + 64; i++)
+            {
+                if(!on_board(g, i)) mark_occupied(g, i);
+            }
+        }
+        if(++tile_column == tiles_per_row)
+        {
+            tile_column = 0;
+            tile_row++;
+        }
+    }
+}
+
+/** Returns the index of a field adjacent to a given one. Within a tile the coordinates
+ * are incremented and decremented on the interleaved bits, and the carry or borrow
+ * out of the tile moves to the adjacent tile.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of a field of the board,
+ * @param[in] d - the direction: 0 - left, 1 - down, 2 - right, 3 - up.
+ * @return The index of the adjacent field, which may belong to the border.
+ */
+static inline uint64_t neighbour(gamma_t* g, uint64_t i, unsigned int d)
+{
+    uint64_t row_bits = i & MORTON_Y_BITS;
+    uint64_t rest = i & ~(uint64_t) MORTON_Y_BITS;
+    switch(d)
+    {
+        case 0:
+            return ((rest - 1) & ~(uint64_t) MORTON_Y_BITS) | row_bits;
+        case 1:
+            return (rest | ((row_bits - 1) & MORTON_Y_BITS)) - (row_bits == 0 ? g->row_stride : 0);
+        case 2:
+            return (((i | MORTON_Y_BITS) + 1) & ~(uint64_t) MORTON_Y_BITS) | row_bits;
+        default:
+        {
+            uint64_t next_bits = ((row_bits | MORTON_X_BITS) + 1) & MORTON_Y_BITS;
+            return (rest | next_bits) + (next_bits == 0 ? g->row_stride : 0);
+        }
+    }
+}
+
+#else
+
+/** Returns the index of the field ( @p x, @p y) in the flat arrays
+ * storing the state of the fields.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] x - the column number, non-negative integer smaller than the value of @p width
+                  from the function @ref gamma_new,
+ * @param[in] y - the row number, non-negative integer smaller than the value of @p height
+                  from the function @ref gamma_new.
+ * @return The index of the field.
+ */
+static uint64_t field_index(gamma_t* g, uint32_t x, uint32_t y)
+{
+    return ((uint64_t) y + 1) * g->row_stride + x;
+}
+
+/** Returns the column number after the last field of a row, which lies in the same tile
+ * of the arrays indexed like the board as a given field.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] x - the column number of the field,
+ * @param[in] y - the row number of the field.
+ * @return The column number, not bigger than the value of @p width from the function @ref gamma_new.
+ */
+static uint32_t tile_run_end(gamma_t* g, uint32_t x, uint32_t y)
+{
+    uint64_t i = field_index(g, x, y);
+    uint64_t end = (i | TILE_MASK) + 1 - (i - x);
+    return end < g->width_x ? (uint32_t) end : g->width_x;
+}
+
+/** Computes the coefficients of a field from its index in the flat arrays
+ * storing the state of the fields.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of a field of the board, not of the border,
+ * @param[out] x - the column number of the field,
+ * @param[out] y - the row number of the field.
+ */
+static void field_coordinates(gamma_t* g, uint64_t i, uint32_t* x, uint32_t* y)
+{
+    *x = i % g->row_stride;
+    *y = i / g->row_stride - 1;
+}
+
+/** Marks the fields of the border within a range of indices as occupied, see @ref is_liberty:
+ * the first and the last row of the array and the column at the end of every row.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] begin - the first index of the range,
+ * @param[in] end - the index after the range, which may lie beyond the arrays.
+ */
+static void mark_border(gamma_t* g, uint64_t begin, uint64_t end)
+{
+    uint64_t last_row = ((uint64_t) g->height_y + 1) * g->row_stride;
+    if(end > last_row + g->row_stride) end = last_row + g->row_stride;
+    if(begin < g->row_stride) mark_occupied_range(g, begin, end < g->row_stride ? end : g->row_stride);
+    uint64_t column = begin - begin % g->row_stride + g->width_x;
+    if(column < begin) column += g->row_stride;
+    for(uint64_t i = column; i < end && i < last_row; i += g->row_stride) mark_occupied(g, i);
+    if(end > last_row) mark_occupied_range(g, begin > last_row ? begin : last_row, end);
+}
+
+/** Returns the index of a field adjacent to a given one.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of a field of the board,
+ * @param[in] d - the direction: 0 - left, 1 - down, 2 - right, 3 - up.
+ * @return The index of the adjacent field, which may belong to the border.
+ */
+static inline uint64_t neighbour(gamma_t* g, uint64_t i, unsigned int d)
+{
+    return i + g->neighbour_offsets[d];
+}
+
+#endif
+
+/** Makes sure that the tile of the bitset of the occupied fields containing a given field
+ * is allocated, marking the fields of the border in it, when it is allocated.
+ * The tiles of a board created at once are marked together with it, see @ref new_game.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field or of a field of the border.
+ * @return True, if the tile is allocated, and false in case of a memory error.
+ */
+static bool reserve_occupied(gamma_t* g, uint64_t i)
+{
+    if(tiled_array_allocated(&g->occupied_bits, i)) return true;
+    if(!tiled_array_reserve(&g->occupied_bits, i)) return false;
+    mark_border(g, i & ~TILE_MASK, (i & ~TILE_MASK) + TILE_FIELDS);
+    return true;
+}
+
+/** Makes sure that the tiles containing a given field are allocated in all the arrays indexed
+ * like the board, so that the field can be taken, and that the tiles of the bitset of the occupied
+ * fields containing its adjacent fields are allocated too, so that @ref is_liberty can read them.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field.
+ * @return True, if the tiles are allocated, and false in case of a memory error.
+ */
+static bool reserve_field(gamma_t* g, uint64_t i)
+{
+    return tiled_array_reserve(&g->board, i) &&
+           tiled_array_reserve(&g->area_labels, i) &&
+           tiled_array_reserve(&g->split_parts, i) &&
+           tiled_array_reserve(&g->field_positions, i) &&
+           reserve_occupied(g, i) &&
+           (!g->sparse ||
+            (reserve_occupied(g, neighbour(g, i, 0)) && reserve_occupied(g, neighbour(g, i, 1)) &&
+             reserve_occupied(g, neighbour(g, i, 2)) && reserve_occupied(g, neighbour(g, i, 3))));
+}
+
+/** Checks if a field belongs to a given player. The field may lie on the border,
+ * which does not belong to any player, so no coordinates have to be checked.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field,
+ * @param[in] player - player number, positive integer.
+ * @return True, if the field belongs to the player, and false otherwise.
+ */
+static bool owned_by(gamma_t* g, uint64_t i, uint32_t player)
+{
+    return read_cell(board_tile(g, i), g->cell_size, i & TILE_MASK) == player;
+}
+
+/** Returns the bitboard of the fields of a player, if the fields are stored as bitboards.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] player - player number, positive integer not bigger than the value of
+ *                     @p players from the function @ref gamma_new.
+ * @return Pointer to the first row of the bitboard.
+ */
+static uint64_t* player_rows(gamma_t* g, uint32_t player)
+{
+    return g->player_rows + (uint64_t) (player - 1) * g->height_y;
+}
+
+/** Returns the owner of a field.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field.
+ * @return The number of the owner of the field, or 0, if it is free.
+ */
+static uint32_t owner_of(gamma_t* g, uint64_t i)
+{
+    return read_cell(board_tile(g, i), g->cell_size, i & TILE_MASK);
+}
+
+/** Changes the owner of a field on the board and in the bitboards of the players, if they are used.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field,
+ * @param[in] owner - number of the new owner of the field, or 0, if it becomes free.
+ */
+static void set_cell(gamma_t* g, uint64_t i, uint32_t owner)
+{
+    if(g->player_rows != NULL)
+    {
+        uint32_t x, y;
+        field_coordinates(g, i, &x, &y);
+        uint32_t prev_owner = owner_of(g, i);
+        if(prev_owner != 0) player_rows(g, prev_owner)[y] &= ~((uint64_t) 1 << x);
+        if(owner != 0) player_rows(g, owner)[y] |= (uint64_t) 1 << x;
+    }
+    write_cell(board_tile(g, i), g->cell_size, i & TILE_MASK, owner);
+}
+
+/** Returns the number of the record of a player in the table of the players.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] player - player number, positive integer not bigger than the value of
+ *                     @p players from the function @ref gamma_new.
+ * @return The number of the record, or 0, if the player has none yet. Record 0 is empty,
+ *         like the record of a player who has never moved, and may be only read,
+ *         apart from the result of @ref gamma_golden_possible, which is the same
+ *         for all such players.
+ */
+static uint32_t player_record(gamma_t* g, uint32_t player)
+{
+    if(g->players.map_players == NULL) return player;
+    return player_table_find(&g->players, player);
+}
+
+/** Appends the root of the tree containing @p label to the array @p roots,
+ * unless it is already there.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] roots - array of distinct roots,
+ * @param[in, out] n - number of elements of @p roots,
+ * @param[in] label - area label of a field, different from @ref NO_AREA.
+ */
+static void append_root(gamma_t* g, uint32_t* roots, unsigned int* n, uint32_t label)
+{
+    uint32_t root = area_find(&g->areas, label);
+    for(unsigned int i = 0; i < *n; i++)
+    {
+        if(roots[i] == root) return;
+    }
+    roots[*n] = root;
+    (*n)++;
+}
+
+/** @brief Finds the distinct areas of a given player that the fields adjacent to a given field belong to.
+ * It does not search the board, but compares the roots of the area labels of the adjacent fields.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field,
+ * @param[in] player  - player number, positive integer not bigger than the value of
+ *                      @p players from the function @ref gamma_new,
+ * @param[out] roots - array of at least four elements, filled with the roots of the found areas.
+ * @return The number of the found areas.
+ */
+static unsigned int adjacent_areas(gamma_t* g, uint64_t i, uint32_t player, uint32_t* roots)
+{
+    unsigned int n = 0;
+    for(unsigned int d = 0; d < 4; d++)
+    {
+        uint64_t next = neighbour(g, i, d);
+        if(owned_by(g, next, player)) append_root(g, roots, &n, *area_label(g, next));
+    }
+    return n;
+}
+/** Adds an area to the list of the areas of a player, which must have room for it,
+ * see @ref reserve_player_areas, and increases the number of areas of the player.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] r - number of the record of the player,
+ * @param[in] root - root of the label of the area.
+ */
+static void list_area(gamma_t* g, uint32_t r, uint32_t root)
+{
+    player_table* t = &g->players;
+    g->areas.position[root] = t->occupied_areas[r];
+    t->areas[r][t->occupied_areas[r]++] = root;
+}
+
+/** Removes an area from the list of the areas of a player, by moving the last area of the list
+ * into its place, and decreases the number of areas of the player.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] r - number of the record of the player,
+ * @param[in] root - root of the label of the area.
+ */
+static void unlist_area(gamma_t* g, uint32_t r, uint32_t root)
+{
+    player_table* t = &g->players;
+    uint32_t position = g->areas.position[root];
+    uint32_t last = t->areas[r][--t->occupied_areas[r]];
+    t->areas[r][position] = last;
+    g->areas.position[last] = position;
+}
+
+/** Joins the given areas of a player and a field just taken by them into one area, or creates
+ * a new area of that field, if there are none. Requires room for one more area in the list
+ * of the areas of the player, see @ref reserve_player_areas.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] r - number of the record of the player,
+ * @param[in] roots - array of distinct roots of the joined areas,
+ * @param[in] n - number of elements of @p roots,
+ * @param[in] x - the column number of the field,
+ * @param[in] y - the row number of the field.
+ * @return The root of the resulting area, or @ref NO_AREA in case of a memory error.
+ */
+static uint32_t join_areas(gamma_t* g, uint32_t r, uint32_t* roots, unsigned int n, uint32_t x, uint32_t y)
+{
+    uint32_t root;
+    if(n == 0)
+    {
+        root = area_new(&g->areas);
+        if(root == NO_AREA) return NO_AREA;
+        list_area(g, r, root);
+    }
+    else
+    {
+        root = roots[0];
+        for(unsigned int i = 1; i < n; i++)
+        {
+            uint32_t joined = area_union(&g->areas, root, roots[i]);
+            unlist_area(g, r, joined == root ? roots[i] : root);
+            root = joined;
+        }
+    }
+    g->areas.size[root] += 1;
+    g->areas.indexed[root] = false;
+    area_box_extend(&g->areas.box[root], x, y);
+    return root;
+}
+
+/** Returns the direction of the first neighbour of a field belonging to one of the given areas
+ * of a player.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field,
+ * @param[in] player - number of the player,
+ * @param[in] roots - array of roots of the areas,
+ * @param[in] n - number of elements of @p roots,
+ * @param[in] skipped - index of a field, which is not treated as a part of any area.
+ * @return The direction, as in @ref neighbour, or 4, if there is no such neighbour.
+ */
+static unsigned int first_neighbour_in(gamma_t* g, uint64_t i, uint32_t player, const uint32_t* roots,
+                                       unsigned int n, uint64_t skipped)
+{
+    for(unsigned int d = 0; d < 4; d++)
+    {
+        uint64_t next = neighbour(g, i, d);
+        if(next == skipped || !owned_by(g, next, player)) continue;
+        uint32_t root = area_find(&g->areas, *area_label(g, next));
+        for(unsigned int k = 0; k < n; k++)
+        {
+            if(roots[k] == root) return d;
+        }
+    }
+    return 4;
+}
+
+/** Checks if a field is free and lies on the board. The fields of the border are marked
+ * as occupied, see @ref mark_border, so a single bit tells both apart from the free fields.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of a field adjacent to a field reserved by @ref reserve_field.
+ * @return True, if the field is a free field of the board, and false otherwise.
+ */
+static bool is_liberty(gamma_t* g, uint64_t i)
+{
+    return (*bitset_word(&g->occupied_bits, i) >> (i % 64) & 1) == 0;
+}
+
+/** Lists the fields of an area in the queue of the first search, see @ref reserve_queue,
+ * marking the reached fields with a label of a search, and then restoring their labels.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] w - pointer to the workspace of the searches,
+ * @param[in] start - index of a field of the area,
+ * @param[in] player - number of the owner of the area,
+ * @param[in] root - root of the label of the area,
+ * @param[in] skipped - index of a field, which is not treated as a part of the area.
+ * @return The queue, with the fields of the area before its @p last.
+ */
+static field_queue* list_area_fields(gamma_t* g, workspace* w, uint64_t start, uint32_t player, uint32_t root,
+                                     uint64_t skipped)
+{
+    field_queue* q = &w->searches[0];
+    queue_clear(q);
+    queue_push(q, start);
+    *area_label(g, start) = SEARCH_LABEL(0);
+    while(!queue_empty(q))
+    {
+        uint64_t field = queue_pop(q);
+        for(unsigned int d = 0; d < 4; d++)
+        {
+            uint64_t next = neighbour(g, field, d);
+            if(next == skipped || !owned_by(g, next, player) || *area_label(g, next) == SEARCH_LABEL(0)) continue;
+            *area_label(g, next) = SEARCH_LABEL(0);
+            queue_push(q, next);
+        }
+    }
+    for(uint64_t j = 0; j < q->last; j++) *area_label(g, q->fields[j]) = root;
+    return q;
+}
+
+/** @brief Counts the liberties of the area formed by joining the given areas of a player
+ * and a field just taken by them, before the areas are joined.
+ * The count starts from the liberties of the biggest area. Then the fields of every other area
+ * are listed, and every free field adjacent to them is added, unless it is adjacent to one of the
+ * areas already counted. Each such free field is checked once, from its first neighbour in the area.
+ * Finally, the free fields adjacent to the taken field and to none of the areas are added.
+ * Listing only the smaller areas keeps the total cost of all the moves low, as a field is listed
+ * only when the area containing it at least doubles. Requires room in the queue of the first
+ * search for all the fields of the player, see @ref reserve_queue, if there are at least
+ * two areas.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] w - pointer to the workspace of the searches,
+ * @param[in] field - index of the taken field,
+ * @param[in] player - number of the player,
+ * @param[in] roots - array of distinct roots of the joined areas,
+ * @param[in] n - number of elements of @p roots,
+ * @param[in] was_free - true, if the field was free before, and so a liberty of the areas.
+ * @return The number of liberties of the joined area.
+ */
+static uint64_t joined_liberties(gamma_t* g, workspace* w, uint64_t field, uint32_t player, uint32_t* roots,
+                                 unsigned int n, bool was_free)
+{
+    uint64_t liberties = 0;
+    uint32_t counted[4];
+    unsigned int n_of_counted = 0, biggest = 0;
+    for(unsigned int k = 1; k < n; k++)
+    {
+        if(g->areas.size[roots[k]] > g->areas.size[roots[biggest]]) biggest = k;
+    }
+    if(n != 0)
+    {
+        liberties = g->areas.liberties[roots[biggest]] - (was_free ? 1 : 0);
+        counted[n_of_counted++] = roots[biggest];
+    }
+    for(unsigned int k = 0; k < n; k++)
+    {
+        if(k == biggest) continue;
+        uint64_t start = field;
+        for(unsigned int d = 0; d < 4 && start == field; d++)
+        {
+            uint64_t next = neighbour(g, field, d);
+            if(owned_by(g, next, player) && area_find(&g->areas, *area_label(g, next)) == roots[k])
+            {
+                start = next;
+            }
+        }
+        field_queue* q = list_area_fields(g, w, start, player, roots[k], field);
+        for(uint64_t j = 0; j < q->last; j++)
+        {
+            for(unsigned int d = 0; d < 4; d++)
+            {
+                uint64_t next = neighbour(g, q->fields[j], d);
+                if(next == field || !is_liberty(g, next)) continue;
+                if(first_neighbour_in(g, next, player, &roots[k], 1, field) != (d + 2) % 4) continue;
+                if(first_neighbour_in(g, next, player, counted, n_of_counted, field) == 4) liberties++;
+            }
+        }
+        counted[n_of_counted++] = roots[k];
+    }
+    for(unsigned int d = 0; d < 4; d++)
+    {
+        uint64_t next = neighbour(g, field, d);
+        if(is_liberty(g, next) && first_neighbour_in(g, next, player, roots, n, field) == 4) liberties++;
+    }
+    return liberties;
+}
+
+/** Takes a field, which has just been taken by a player, from the liberties of the adjacent
+ * areas of the other players.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] field - index of the field,
+ * @param[in] player - number of the player.
+ */
+static void occupy_liberty(gamma_t* g, uint64_t field, uint32_t player)
+{
+    uint32_t roots[4];
+    unsigned int n = 0;
+    for(unsigned int d = 0; d < 4; d++)
+    {
+        uint64_t next = neighbour(g, field, d);
+        uint32_t owner = owner_of(g, next);
+        if(owner != 0 && owner != player) append_root(g, roots, &n, *area_label(g, next));
+    }
+    for(unsigned int k = 0; k < n; k++) g->areas.liberties[roots[k]] -= 1;
+}
+
+/** Removes from the liberties of an area the free fields, which were adjacent to it only
+ * through a field just taken from it by a golden move, already marked as free on the board.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] field - index of the field,
+ * @param[in] player - number of the previous owner of the field,
+ * @param[in] root - root of the label of the area.
+ * @return The number of the removed liberties.
+ */
+static uint64_t release_liberties(gamma_t* g, uint64_t field, uint32_t player, uint32_t root)
+{
+    uint64_t released = 0;
+    for(unsigned int d = 0; d < 4; d++)
+    {
+        uint64_t next = neighbour(g, field, d);
+        if(is_liberty(g, next) && first_neighbour_in(g, next, player, &root, 1, field) == 4) released++;
+    }
+    g->areas.liberties[root] -= released;
+    return released;
+}
+
+/** @brief Counts the liberties of a part split off an area, adjacent to one of its fields.
+ * Every free field is counted for the part from its first neighbour in the part. If it is not
+ * adjacent to the rest of the area, which keeps the old root, it is also removed from the liberties
+ * of the rest, from its first neighbour in any of the parts. Called for every field of every part,
+ * after all of them have got their labels.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] field - index of a field of the part,
+ * @param[in] player - number of the owner of the area,
+ * @param[in] root - root of the label of the rest of the area,
+ * @param[in] parts - array of the labels of the parts, which have split off,
+ * @param[in] n - number of elements of @p parts,
+ * @param[in] k - position of the part of the field in @p parts,
+ * @param[in] taken - index of the field taken from the area, already free on the board.
+ */
+static void part_liberties(gamma_t* g, uint64_t field, uint32_t player, uint32_t root, const uint32_t* parts,
+                           unsigned int n, unsigned int k, uint64_t taken)
+{
+    for(unsigned int d = 0; d < 4; d++)
+    {
+        uint64_t next = neighbour(g, field, d);
+        if(next == taken || !is_liberty(g, next)) continue;
+        unsigned int back = (d + 2) % 4;
+        if(first_neighbour_in(g, next, player, &parts[k], 1, taken) == back) g->areas.liberties[parts[k]] += 1;
+        if(first_neighbour_in(g, next, player, parts, n, taken) == back &&
+           first_neighbour_in(g, next, player, &root, 1, taken) == 4)
+        {
+            g->areas.liberties[root] -= 1;
+        }
+    }
+}
+
+/** @brief Counts the liberties of all the areas of a player anew, in one pass over the index
+ * of the fields of the player, after the counting has been deferred for them.
+ * Every free field is counted from its first neighbour in each of the areas adjacent to it.
+ * The adjacent fields are told from the border by their bits, see @ref is_liberty, so the pass
+ * computes no coordinates.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] player - number of the player, whose counting has been deferred.
+ */
+static void count_player_liberties(gamma_t* g, uint32_t player)
+{
+    player_table* t = &g->players;
+    uint32_t r = player_record(g, player);
+    for(uint32_t k = 0; k < t->occupied_areas[r]; k++) g->areas.liberties[t->areas[r][k]] = 0;
+    for(uint64_t k = 0; k < t->occupied_fields[r]; k++)
+    {
+        uint64_t field = t->fields[r][k];
+        uint32_t root = area_find(&g->areas, *area_label(g, field));
+        for(unsigned int d = 0; d < 4; d++)
+        {
+            uint64_t next = neighbour(g, field, d);
+            if(is_liberty(g, next) && first_neighbour_in(g, next, player, &root, 1, next) == (d + 2) % 4)
+            {
+                g->areas.liberties[root] += 1;
+            }
+        }
+    }
+    set_player_flag(t->liberties_stale, r, false);
+    g->n_of_stale--;
+}
+
+/** Counts the liberties of the areas of every player, for whom the counting has been deferred.
+ * @param[in, out] g - pointer to the struct storing the game state.
+ */
+static void resolve_liberties(gamma_t* g)
+{
+    for(uint32_t a = 0; a < g->n_of_active && g->n_of_stale != 0; a++)
+    {
+        uint32_t player = g->active_players[a];
+        if(player_flag(g->players.liberties_stale, player_record(g, player))) count_player_liberties(g, player);
+    }
+}
+
+
+/** Returns the index of the group of searches of @ref split_search containing a given search.
+ * @param[in] s - array of the searches,
+ * @param[in] i - index of the search.
+ * @return The index of the search representing the group.
+ */
+static unsigned int search_group(search_t* s, unsigned int i)
+{
+    while(s[i].group != i) i = s[i].group;
+    return i;
+}
+
+/** Checks if none of the searches of a group has any fields left to expand.
+ * @param[in] s - array of the searches,
+ * @param[in] n - number of the searches,
+ * @param[in] group - index of the search representing the group.
+ * @return True, if the whole group has finished, and false otherwise.
+ */
+static bool group_finished(search_t* s, unsigned int n, unsigned int group)
+{
+    for(unsigned int i = 0; i < n; i++)
+    {
+        if(search_group(s, i) == group && !queue_empty(s[i].pending)) return false;
+    }
+    return true;
+}
+
+/** Starts a search of @ref split_search in a given field.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] w - pointer to the workspace of the searches,
+ * @param[out] s - pointer to the started search,
+ * @param[in] i - index of the started search,
+ * @param[in] field - index of the field,
+ * @param[in] limit - number of fields of the searched area.
+ * @return True, if the search has been started, and false in case of a memory error.
+ */
+static bool search_start(gamma_t* g, workspace* w, search_t* s, unsigned int i, uint64_t field, uint64_t limit)
+{
+    s->pending = &w->searches[i];
+    s->group = i;
+    s->limit = limit;
+    queue_clear(s->pending);
+    if(!queue_grow(s->pending, limit)) return false;
+    queue_push(s->pending, field);
+    *area_label(g, field) = SEARCH_LABEL(i);
+    return true;
+}
+
+/** Joins the groups of two searches of @ref split_search, if they are different.
+ * @param[in, out] s - array of the searches,
+ * @param[in] i - index of the first search,
+ * @param[in] j - index of the second search,
+ * @param[in, out] unfinished - number of groups of searches that have not finished yet.
+ */
+static void join_searches(search_t* s, unsigned int i, unsigned int j, unsigned int* unfinished)
+{
+    unsigned int a = search_group(s, i);
+    unsigned int b = search_group(s, j);
+    if(a != b)
+    {
+        s[b].group = a;
+        (*unfinished)--;
+    }
+}
+
+/** Handles a field adjacent to the one expanded by the search no. @p i of @ref split_search:
+ * claims it for the search, or joins the groups of two searches that have met.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] s - array of the searches,
+ * @param[in] i - index of the expanding search,
+ * @param[in] field - index of the field,
+ * @param[in, out] unfinished - number of groups of searches that have not finished yet.
+ * @return True, if the field has been handled, and false, if the queue of the search cannot grow.
+ */
+static bool search_visit(gamma_t* g, search_t* s, unsigned int i, uint64_t field, unsigned int* unfinished)
+{
+    uint32_t* label = area_label(g, field);
+    if(*label > SEARCH_LABEL(MAX_SEARCHES - 1))
+    {
+        if(!queue_grow(s[i].pending, s[i].limit)) return false;
+        *label = SEARCH_LABEL(i);
+        queue_push(s[i].pending, field);
+        return true;
+    }
+    join_searches(s, i, *label - SEARCH_LABEL(0), unfinished);
+    return true;
+}
+
+/** Expands one field of the search no. @p i of @ref split_search.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] s - array of the searches,
+ * @param[in] n - number of the searches,
+ * @param[in] i - index of the expanding search,
+ * @param[in] player - number of the player, whose fields are searched,
+ * @param[in, out] unfinished - number of groups of searches that have not finished yet,
+ * @param[in] cell_size - number of bytes storing one field of the board, see @ref WITH_CELL_SIZE.
+ * @return True, if the field has been expanded, and false in case of a memory error.
+ */
+static inline __attribute__((always_inline))
+bool search_step(gamma_t* g, search_t* s, unsigned int n, unsigned int i, uint32_t player,
+                 unsigned int* unfinished, unsigned int cell_size)
+{
+    uint64_t field = queue_pop(s[i].pending);
+    for(unsigned int d = 0; d < 4; d++)
+    {
+        uint64_t next = neighbour(g, field, d);
+        if(read_cell(board_tile(g, next), cell_size, next & TILE_MASK) == player
+           && !search_visit(g, s, i, next, unfinished))
+        {
+            return false;
+        }
+    }
+    if(queue_empty(s[i].pending) && group_finished(s, n, search_group(s, i))) (*unfinished)--;
+    return true;
+}
+
+/** Expands the searches of @ref split_search in turns, one field each, until at most one group
+ * of them has fields left to expand, or the given number of fields has been expanded.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] s - array of the searches,
+ * @param[in] n - number of the searches,
+ * @param[in] player - number of the player, whose fields are searched,
+ * @param[in] unfinished - number of groups of searches that have not finished yet,
+ * @param[in] budget - maximal number of expanded fields,
+ * @param[in] cell_size - number of bytes storing one field of the board, see @ref WITH_CELL_SIZE.
+ * @return 1, if at most one group has fields left to expand, and 0, if the searches have run
+ *         out of the budget or of memory.
+ */
+static inline __attribute__((always_inline))
+int expand_searches(gamma_t* g, search_t* s, unsigned int n, uint32_t player, unsigned int unfinished,
+                    uint64_t budget, unsigned int cell_size)
+{
+    uint64_t expanded = 0;
+    while(unfinished > 1)
+    {
+        for(unsigned int i = 0; i < n && unfinished > 1; i++)
+        {
+            if(queue_empty(s[i].pending)) continue;
+            if(expanded++ == budget || !search_step(g, s, n, i, player, &unfinished, cell_size)) return 0;
+        }
+    }
+    return 1;
+}
+
+/** Writes a label into all the fields reached by a search of @ref split_search, and extends
+ * the box of the label to contain them, if it is a new one. The fields stay in the queue
+ * of the search until the next search.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] s - pointer to the search,
+ * @param[in] label - the written label,
+ * @param[in] boxed - true, if the box of the label is to be extended.
+ */
+static void search_finish(gamma_t* g, search_t* s, uint32_t label, bool boxed)
+{
+    for(uint64_t j = 0; j < s->pending->last; j++)
+    {
+        *area_label(g, s->pending->fields[j]) = label;
+        if(!boxed) continue;
+        uint32_t x, y;
+        field_coordinates(g, s->pending->fields[j], &x, &y);
+        area_box_extend(&g->areas.box[label], x, y);
+    }
+}
+
+/** @brief Counts the areas of a player adjacent to a field, which has just
+ * been taken from them, and gives new labels to the areas that have split off.
+ * A search is started in every adjacent field of the player, and the searches are expanded
+ * in turns, one field each. Searches that meet are joined into one group. Everything stops
+ * as soon as at most one group has fields left to expand, so the number of visited fields
+ * is proportional to the size of the smaller parts, and not of the whole area. Only the
+ * finished groups get new labels, the fields reached by the last group get back the old one.
+ * Before that, searches started in two fields sharing a corner are joined at once, if the
+ * field in that corner belongs to the player as well. Usually the adjacent fields are connected
+ * this way around the taken field, and then no field has to be expanded at all.
+ * The parts with new labels are added to the list of the areas of the player, with their liberties,
+ * see @ref part_liberties, and the old area is removed from it, if no field is left in it.
+ * Requires enough space in the forest for @ref MAX_SEARCHES new labels and room for as many
+ * areas of the player, see @ref reserve_player_areas. The queues of the searches grow
+ * as the searches reach new fields, see @ref queue_grow.
+ * If more fields than @p budget would have to be expanded, or a queue cannot grow,
+ * the searches are abandoned, and the reached fields get back the label @p root,
+ * with nothing else changed.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] w - pointer to the workspace of the searches,
+ * @param[in] field - index of the field,
+ * @param[in] player - number of the previous owner of the field,
+ * @param[in] root - root of the label of the area, which contained the field, with its size
+ *                   already decreased by one,
+ * @param[in] budget - maximal number of expanded fields, see @ref split_budget.
+ * @return The number of areas of the player adjacent to the field, or @ref SPLIT_ABANDONED.
+ */
+static unsigned int split_search(gamma_t* g, workspace* w, uint64_t field, uint32_t player, uint32_t root,
+                                 uint64_t budget)
+{
+    search_t s[MAX_SEARCHES];
+    unsigned int n = 0;
+    unsigned int started[4]; // index of the search started in the field in each direction
+    for(unsigned int d = 0; d < 4; d++)
+    {
+        uint64_t next = neighbour(g, field, d);
+        started[d] = MAX_SEARCHES;
+        if(!owned_by(g, next, player)) continue;
+        if(!search_start(g, w, &s[n], n, next, g->areas.size[root]))
+        {
+            for(unsigned int j = 0; j < n; j++) search_finish(g, &s[j], root, false);
+            return SPLIT_ABANDONED;
+        }
+        started[d] = n++;
+    }
+    unsigned int unfinished = n;
+    for(unsigned int d = 0; d < 4 && unfinished > 1; d++)
+    {
+        unsigned int e = (d + 1) % 4;
+        if(started[d] == MAX_SEARCHES || started[e] == MAX_SEARCHES) continue;
+        uint64_t corner = neighbour(g, neighbour(g, field, d), e);
+        if(owned_by(g, corner, player)) join_searches(s, started[d], started[e], &unfinished);
+    }
+    if(!WITH_CELL_SIZE(g, expand_searches, g, s, n, player, unfinished, budget))
+    {
+        for(unsigned int i = 0; i < n; i++) search_finish(g, &s[i], root, false);
+        return SPLIT_ABANDONED;
+    }
+    unsigned int areas = 0;
+    uint32_t labels[MAX_SEARCHES];
+    for(unsigned int i = 0; i < n; i++)
+    {
+        if(search_group(s, i) != i) continue;
+        areas++;
+        if(group_finished(s, n, i)) labels[i] = area_new(&g->areas);
+        else labels[i] = root;
+    }
+    uint32_t r = player_record(g, player);
+    for(unsigned int i = 0; i < n; i++)
+    {
+        if(search_group(s, i) == i && labels[i] != root) list_area(g, r, labels[i]);
+    }
+    for(unsigned int i = 0; i < n; i++)
+    {
+        uint32_t label = labels[search_group(s, i)];
+        if(label != root)
+        {
+            g->areas.size[label] += s[i].pending->last;
+            g->areas.size[root] -= s[i].pending->last;
+        }
+        search_finish(g, &s[i], label, label != root);
+    }
+    uint32_t parts[MAX_SEARCHES];
+    unsigned int n_of_parts = 0, part[MAX_SEARCHES];
+    for(unsigned int i = 0; i < n; i++)
+    {
+        if(search_group(s, i) != i || labels[i] == root) continue;
+        part[i] = n_of_parts;
+        parts[n_of_parts++] = labels[i];
+    }
+    for(unsigned int i = 0; i < n; i++)
+    {
+        unsigned int group = search_group(s, i);
+        if(labels[group] == root) continue;
+        for(uint64_t j = 0; j < s[i].pending->last; j++)
+        {
+            part_liberties(g, s[i].pending->fields[j], player, root, parts, n_of_parts, part[group], field);
+        }
+    }
+    if(g->areas.size[root] == 0) unlist_area(g, r, root);
+    g->areas.indexed[root] = false;
+    return areas;
+}
+
+/** @brief Counts the areas of a player adjacent to a field, which has just been taken from them,
+ * and gives new labels to the areas that have split off, using the bitboards of the fields.
+ * Does the same as @ref split_search, but every part is found by flooding the bitboard
+ * of the fields of the player from one of the adjacent fields, a whole row at once. All the parts
+ * except the biggest one get new labels. Requires enough space in the forest for
+ * @ref MAX_SEARCHES new labels, as many areas of the player, see @ref reserve_player_areas,
+ * and room for the bitboards of @ref MAX_SEARCHES parts, see @ref reserve_rows.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] w - pointer to the workspace of the searches,
+ * @param[in] field - index of the field, already removed from the bitboard of the player,
+ * @param[in] player - number of the previous owner of the field,
+ * @param[in] root - root of the label of the area, which contained the field, with its size
+ *                   already decreased by one.
+ * @return The number of areas of the player adjacent to the field.
+ */
+static unsigned int bitboard_split(gamma_t* g, workspace* w, uint64_t field, uint32_t player, uint32_t root)
+{
+    uint32_t height = g->height_y;
+    uint64_t* parts[MAX_SEARCHES];
+    uint64_t sizes[MAX_SEARCHES];
+    unsigned int n = 0, largest = 0;
+    for(unsigned int d = 0; d < 4; d++)
+    {
+        uint64_t next = neighbour(g, field, d);
+        if(!owned_by(g, next, player)) continue;
+        uint32_t x, y;
+        field_coordinates(g, next, &x, &y);
+        bool reached = false;
+        for(unsigned int k = 0; k < n; k++) reached |= (parts[k][y] >> x) & 1;
+        if(reached) continue;
+        parts[n] = w->rows + (uint64_t) n * height;
+        memset(parts[n], 0, height * sizeof(uint64_t));
+        parts[n][y] = (uint64_t) 1 << x;
+        bitboard_flood(player_rows(g, player), parts[n], height);
+        sizes[n] = bitboard_count(parts[n], height);
+        if(sizes[n] > sizes[largest]) largest = n;
+        n++;
+    }
+    uint32_t r = player_record(g, player);
+    uint32_t labels[MAX_SEARCHES];
+    unsigned int n_of_labels = 0;
+    for(unsigned int k = 0; k < n; k++)
+    {
+        if(k == largest) continue;
+        uint32_t label = area_new(&g->areas);
+        labels[n_of_labels++] = label;
+        list_area(g, r, label);
+        g->areas.size[label] = sizes[k];
+        g->areas.size[root] -= sizes[k];
+        for(uint32_t y = 0; y < height; y++)
+        {
+            for(uint64_t row = parts[k][y]; row != 0; row &= row - 1)
+            {
+                *area_label(g, field_index(g, __builtin_ctzll(row), y)) = label;
+                area_box_extend(&g->areas.box[label], __builtin_ctzll(row), y);
+            }
+        }
+    }
+    for(unsigned int k = 0, m = 0; k < n; k++)
+    {
+        if(k == largest) continue;
+        for(uint32_t y = 0; y < height; y++)
+        {
+            for(uint64_t row = parts[k][y]; row != 0; row &= row - 1)
+            {
+                uint64_t i = field_index(g, __builtin_ctzll(row), y);
+                part_liberties(g, i, player, root, labels, n_of_labels, m, field);
+            }
+        }
+        m++;
+    }
+    if(g->areas.size[root] == 0) unlist_area(g, r, root);
+    g->areas.indexed[root] = false;
+    return n;
+}
+
+/** Writes the wide bitboard of the fields of a player within a box, see @ref mask_split.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] player - number of the player,
+ * @param[in] box - pointer to the box,
+ * @param[in] words - number of words of every row of the bitboard,
+ * @param[out] mask - the bitboard,
+ * @param[in] cell_size - number of bytes storing one field of the board, see @ref WITH_CELL_SIZE.
+ * @return Always 0, so that the function can be called by @ref WITH_CELL_SIZE.
+ */
+static inline __attribute__((always_inline))
+int extract_mask(gamma_t* g, uint32_t player, const area_box* box, uint32_t words, uint64_t* mask,
+                 unsigned int cell_size)
+{
+    for(uint32_t y = box->min_y; y <= box->max_y; y++)
+    {
+        uint64_t* row = mask + (uint64_t) (y - box->min_y) * words;
+        memset(row, 0, words * sizeof(uint64_t));
+        for(uint32_t x = box->min_x; x <= box->max_x; x++)
+        {
+            uint64_t i = field_index(g, x, y);
+            if(read_cell(board_tile(g, i), cell_size, i & TILE_MASK) != player) continue;
+            uint32_t bit = x - box->min_x;
+            row[bit / 64] |= (uint64_t) 1 << (bit % 64);
+        }
+    }
+    return 0;
+}
+
+/** @brief Counts the areas of a player adjacent to a field, which has just been taken from them,
+ * and gives new labels to the areas that have split off, by flooding a wide bitboard.
+ * Does the same as @ref bitboard_split, but for a board of any size: the fields of the player
+ * within the box of the area are first written into a wide bitboard, one bit per field,
+ * and every part is found by flooding it, 64 fields at once. Used, when @ref split_search
+ * would expand more fields than it costs. If the floods need more than @ref MASK_SPLIT_SWEEPS
+ * sweeps, they are abandoned before anything is changed. Requires enough space in the forest
+ * for @ref MAX_SEARCHES new labels, as many areas of the player, see @ref reserve_player_areas,
+ * and room for the bitboards, see @ref split_budget.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] w - pointer to the workspace of the searches,
+ * @param[in] field - index of the field, already free,
+ * @param[in] player - number of the previous owner of the field,
+ * @param[in] root - root of the label of the area, which contained the field, with its size
+ *                   already decreased by one.
+ * @return The number of areas of the player adjacent to the field, or @ref SPLIT_ABANDONED.
+ */
+static unsigned int mask_split(gamma_t* g, workspace* w, uint64_t field, uint32_t player, uint32_t root)
+{
+    area_box box = g->areas.box[root];
+    uint32_t words = (box.max_x - box.min_x) / 64 + 1;
+    uint32_t height = box.max_y - box.min_y + 1;
+    uint64_t n_of_words = (uint64_t) words * height;
+    uint64_t* mask = w->rows;
+    uint64_t* parts[MAX_SEARCHES];
+    uint64_t sizes[MAX_SEARCHES];
+    unsigned int n = 0, largest = 0;
+    uint32_t sweeps = MASK_SPLIT_SWEEPS;
+    WITH_CELL_SIZE(g, extract_mask, g, player, &box, words, mask);
+    for(unsigned int d = 0; d < 4; d++)
+    {
+        uint64_t next = neighbour(g, field, d);
+        if(!owned_by(g, next, player)) continue;
+        uint32_t x, y;
+        field_coordinates(g, next, &x, &y);
+        uint64_t word = (uint64_t) (y - box.min_y) * words + (x - box.min_x) / 64;
+        uint64_t bit = (uint64_t) 1 << ((x - box.min_x) % 64);
+        bool reached = false;
+        for(unsigned int k = 0; k < n; k++) reached |= (parts[k][word] & bit) != 0;
+        if(reached) continue;
+        parts[n] = mask + (n + 1) * n_of_words;
+        memset(parts[n], 0, n_of_words * sizeof(uint64_t));
+        parts[n][word] = bit;
+        if(!wide_bitboard_flood(mask, parts[n], words, height, &sweeps)) return SPLIT_ABANDONED;
+        sizes[n] = bitboard_count(parts[n], n_of_words);
+        if(sizes[n] > sizes[largest]) largest = n;
+        n++;
+    }
+    uint32_t r = player_record(g, player);
+    uint32_t labels[MAX_SEARCHES];
+    unsigned int n_of_labels = 0;
+    for(unsigned int k = 0; k < n; k++)
+    {
+        if(k == largest) continue;
+        uint32_t label = area_new(&g->areas);
+        labels[n_of_labels++] = label;
+        list_area(g, r, label);
+        g->areas.size[label] = sizes[k];
+        g->areas.size[root] -= sizes[k];
+        for(uint64_t j = 0; j < n_of_words; j++)
+        {
+            for(uint64_t row = parts[k][j]; row != 0; row &= row - 1)
+            {
+                uint32_t x = box.min_x + (uint32_t) (j % words) * 64 + __builtin_ctzll(row);
+                uint32_t y = box.min_y + (uint32_t) (j / words);
+                *area_label(g, field_index(g, x, y)) = label;
+                area_box_extend(&g->areas.box[label], x, y);
+            }
+        }
+    }
+    for(unsigned int k = 0, m = 0; k < n; k++)
+    {
+        if(k == largest) continue;
+        for(uint64_t j = 0; j < n_of_words; j++)
+        {
+            for(uint64_t row = parts[k][j]; row != 0; row &= row - 1)
+            {
+                uint32_t x = box.min_x + (uint32_t) (j % words) * 64 + __builtin_ctzll(row);
+                uint32_t y = box.min_y + (uint32_t) (j / words);
+                part_liberties(g, field_index(g, x, y), player, root, labels, n_of_labels, m, field);
+            }
+        }
+        m++;
+    }
+    if(g->areas.size[root] == 0) unlist_area(g, r, root);
+    g->areas.indexed[root] = false;
+    return n;
+}
+
+/** Chooses the number of fields, which @ref split_search may expand after a field is taken
+ * from an area, before it is abandoned for @ref mask_split, and makes sure there is room for
+ * the bitboards of @ref mask_split, if it may be needed.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] w - pointer to the workspace of the searches,
+ * @param[in] root - root of the label of the area.
+ * @return The number of fields, unlimited, if the box of the area is small, or if there
+ *         is not enough memory for the bitboards.
+ */
+static uint64_t split_budget(gamma_t* g, workspace* w, uint32_t root)
+{
+    area_box* box = &g->areas.box[root];
+    uint64_t width = (uint64_t) box->max_x - box->min_x + 1;
+    uint64_t height = (uint64_t) box->max_y - box->min_y + 1;
+    if(width * height < MASK_SPLIT_MIN_FIELDS) return UINT64_MAX;
+    if(!reserve_rows(w, (MAX_SEARCHES + 1) * ((width + 63) / 64) * height)) return UINT64_MAX;
+    return width * height / MASK_SPLIT_RATIO;
+}
+
+/** Makes sure an array has room for one more element, doubling its size if needed.
+ * @param[in, out] array - pointer to the array,
+ * @param[in, out] capacity - number of elements the array has room for,
+ * @param[in] size - number of elements in use,
+ * @param[in] element_size - size of one element.
+ * @return True, if there is room for one more element, and false in case of a memory error.
+ */
+static bool make_room(void** array, uint64_t* capacity, uint64_t size, size_t element_size)
+{
+    if(size < *capacity) return true;
+    uint64_t new_capacity = *capacity == 0 ? 64 : 2 * *capacity;
+    void* new_array = realloc(*array, new_capacity * element_size);
+    if(new_array == NULL) return false;
+    *array = new_array;
+    *capacity = new_capacity;
+    return true;
+}
+
+/** @brief Indexes the cut fields of the area containing a given field.
+ * For every field of the area, computes the number of parts the area splits into
+ * after that field is taken from it, using Tarjan's depth-first search for articulation
+ * points, started in the given field. If the field is the root of the search tree, this is the
+ * number of its children. Otherwise, it is one more than the number of children, whose
+ * subtrees have no back edge leading above the field.
+ * Visited fields are marked with @ref DFS_VISITED in place of their numbers of parts, and keep
+ * their order of visiting in place of their area labels. Both are written from the list of the
+ * visited fields at the end, so the cost depends only on the size of the area and not of the board.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] w - pointer to the workspace of the searches,
+ * @param[in] start - index of the field,
+ * @param[in] root - root of the label of the area,
+ * @param[in] cell_size - number of bytes storing one field of the board, see @ref WITH_CELL_SIZE.
+ * @return True, if the area has been indexed, and false in case of a memory error.
+ */
+static inline __attribute__((always_inline))
+bool index_area_cells(gamma_t* g, workspace* w, uint64_t start, uint32_t root, unsigned int cell_size)
+{
+    uint32_t player = read_cell(board_tile(g, start), cell_size, start & TILE_MASK);
+    uint64_t depth = 0, visited = 0;
+    bool success = make_room((void**) &w->dfs_stack, &w->dfs_stack_capacity, 0, sizeof(dfs_frame)) &&
+                   make_room((void**) &w->dfs_visits, &w->dfs_visits_capacity, 0, sizeof(dfs_visit));
+    dfs_frame* stack = w->dfs_stack;
+    dfs_visit* visits = w->dfs_visits;
+    if(success)
+    {
+        visits[0] = (dfs_visit) {start, 1, 0, 0};
+        *split_part(g, start) = DFS_VISITED;
+        *area_label(g, start) = visited = 1;
+        stack[0] = (dfs_frame) {start, 1, 0};
+        depth = 1;
+    }
+    while(success && depth > 0)
+    {
+        dfs_frame* top = &stack[depth-1];
+        if(top->direction == 4)
+        {
+            dfs_visit* child = &visits[top->order-1];
+            depth--;
+            if(depth == 0) continue;
+            dfs_visit* parent = &visits[stack[depth-1].order-1];
+            if(child->low < parent->low) parent->low = child->low;
+            if(child->low >= stack[depth-1].order) parent->separated++;
+            continue;
+        }
+        uint64_t next = neighbour(g, top->field, top->direction++);
+        if(read_cell(board_tile(g, next), cell_size, next & TILE_MASK) != player) continue;
+        if(*split_part(g, next) == DFS_VISITED)
+        {
+            uint32_t order = *area_label(g, next);
+            if(order < visits[top->order-1].low) visits[top->order-1].low = order;
+            continue;
+        }
+        visits[top->order-1].children++;
+        success = make_room((void**) &w->dfs_stack, &w->dfs_stack_capacity, depth, sizeof(dfs_frame)) &&
+                  make_room((void**) &w->dfs_visits, &w->dfs_visits_capacity, visited, sizeof(dfs_visit));
+        if(!success) break;
+        stack = w->dfs_stack;
+        visits = w->dfs_visits;
+        visited++;
+        visits[visited-1] = (dfs_visit) {next, visited, 0, 0};
+        *split_part(g, next) = DFS_VISITED;
+        *area_label(g, next) = visited;
+        stack[depth] = (dfs_frame) {next, visited, 0};
+        depth++;
+    }
+    for(uint64_t i = 0; i < visited; i++)
+    {
+        if(i == 0) *split_part(g, visits[i].field) = visits[i].children;
+        else *split_part(g, visits[i].field) = visits[i].separated + 1;
+        *area_label(g, visits[i].field) = root;
+    }
+    g->areas.indexed[root] = success;
+    return success;
+}
+
+/** Indexes the cut fields of the area containing a given field, see @ref index_area_cells.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] w - pointer to the workspace of the searches,
+ * @param[in] start - index of the field,
+ * @param[in] root - root of the label of the area.
+ * @return True, if the area has been indexed, and false in case of a memory error.
+ */
+static bool index_area(gamma_t* g, workspace* w, uint64_t start, uint32_t root)
+{
+    return WITH_CELL_SIZE(g, index_area_cells, g, w, start, root);
+}
+
+/** Returns the ascii value of the digit corresponding to the number x.
+ * @param[in] x - non-negative integer smaller or equal to 9.
+ * @return The ascii value of the digit corresponding to the number x.
+ */
+static char number_to_digit(int x)
+{
+    return (char) x + 48;
+}
+
+/** @brief Writes the decimal representation of a number into an array.
+ * @param[in, out] beginning - pointer to the target place in the array,
+ * @param[in] total_length - the total length of the number's representation
+ *                           and the preceding spaces,
+ * @param[in] x - the number to be written,
+ * @param[in] white - the white character appended at the end.
+ */
+static void write_number(char* beginning, unsigned int total_length, uint32_t x, char white)
+{
+    if(x == 0)
+    {
+        for(unsigned int i = 0; i < total_length-1; i++) beginning[i] = ' ';
+        beginning[total_length-1] = '.';
+    }
+    else
+    {
+        unsigned int x_length = decimal_length(x);
+        unsigned int num_of_spaces = total_length - x_length;
+        for(unsigned int i = 0; i < num_of_spaces; i++) beginning[i] = ' ';
+        for(unsigned int j = total_length-1; x > 0; j--)
+        {
+            beginning[j] = number_to_digit(x%10);
+            x /= 10;
+        }
+    }
+    beginning[total_length] = white;
+}
+
+#ifndef MORTON_LAYOUT
+
+/** Creates the string storing the board state in case
+ * not all player numbers are single-digit numbers. The rows are read in the order
+ * in which they are stored, from the bottom one.
+ @param[in] g - pointer to the struct storing the game state,
+ @param[in] max_digits - maximal length of the representation of a player number.
+ @return pointer to the resulting buffer.
+ */
+static char* fill_buffer_with_spaces(gamma_t* g, unsigned int max_digits)
+{
+    char* buffer = malloc(((max_digits+1)*g->width_x* (uint64_t) g->height_y + 1)*sizeof(char));
+    char* result = buffer;
+    if(buffer == NULL) return NULL;
+    uint32_t width = g->width_x;
+    uint64_t row_length = (max_digits + 1) * (uint64_t) width;
+    for(uint32_t y = 0; y < g->height_y; y++)
+    {
+        uint64_t row = field_index(g, 0, y);
+        buffer = result + (g->height_y - 1 - y) * row_length;
+        for(uint32_t x = 0; x < width-1; x++)
+        {
+            write_number(buffer, max_digits, owner_of(g, row + x), ' ');
+            buffer += max_digits + 1;
+        }
+        write_number(buffer, max_digits, owner_of(g, row + width - 1), '\n');
+    }
+    result[row_length * g->height_y] = '\0';
+    return result;
+}
+
+/** @brief Creates the string storing the board state in case
+ * all player numbers are single-digit numbers. Fields are not
+ * separated by spaces in this case.
+ @param[in] g - pointer to the struct storing the game state,
+ @return pointer to the resulting buffer.
+ */
+static char* fill_buffer_without_spaces(gamma_t* g)
+{
+    char* buffer = malloc(((g->width_x + 1) * (uint64_t) g->height_y + 1)* sizeof(char));
+    char* result = buffer;
+    if(buffer == NULL) return NULL;
+    uint32_t width = g->width_x;
+    unsigned int owner_num;
+    uint64_t row_length = (uint64_t) width + 1;
+    for(uint32_t y = 0; y < g->height_y; y++)
+    {
+        uint64_t row = field_index(g, 0, y);
+        buffer = result + (g->height_y - 1 - y) * row_length;
+        for(uint32_t x = 0; x < width; x++)
+        {
+            owner_num = owner_of(g, row + x);
+            if(owner_num != 0) buffer[0] = number_to_digit(owner_num);
+            else buffer[0] = '.';
+            buffer++;
+        }
+        buffer[0] = '\n';
+    }
+    result[row_length * g->height_y] = '\0';
+    return result;
+}
+
+#else
+
+/** @brief Creates the string storing the board state, walking the board tile by tile,
+ * in the order in which the fields are stored. Every field is written directly into its place
+ * in the string, as in @ref fill_buffer_with_spaces or @ref fill_buffer_without_spaces.
+ @param[in] g - pointer to the struct storing the game state,
+ @param[in] max_digits - maximal length of the representation of a player number.
+ @return pointer to the resulting buffer.
+ */
+static char* fill_buffer_by_tiles(gamma_t* g, unsigned int max_digits)
+{
+    uint64_t field_length = max_digits == 1 ? 1 : max_digits + 1;
+    uint64_t row_length = g->width_x * field_length + (max_digits == 1);
+    char* buffer = malloc((row_length * g->height_y + 1) * sizeof(char));
+    if(buffer == NULL) return NULL;
+    uint64_t tile_rows = ((uint64_t) g->height_y + 9) >> 3;
+    for(uint64_t tile = 0; tile < tile_rows * g->row_stride; tile += 64)
+    {
+        for(uint64_t i = tile; i < tile + 64; i++)
+        {
+            if(!on_board(g, i)) continue;
+            uint32_t x, y;
+            field_coordinates(g, i, &x, &y);
+            char* place = buffer + (g->height_y - 1 - y) * row_length + x * field_length;
+            uint32_t owner = owner_of(g, i);
+            if(max_digits != 1)
+            {
+                write_number(place, max_digits, owner, x == g->width_x - 1 ? '\n' : ' ');
+            }
+            else
+            {
+                place[0] = owner != 0 ? number_to_digit(owner) : '.';
+                if(x == g->width_x - 1) place[1] = '\n';
+            }
+        }
+    }
+    buffer[row_length * g->height_y] = '\0';
+    return buffer;
+}
+
+#endif
+
+/** Makes sure a field can be added to the index of the fields of a player without
+ * allocating memory, creating the record of the player, if they have none yet.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] player - player number, positive integer not bigger than the value of
+ *                     @p players from the function @ref gamma_new.
+ * @return The number of the record of the player, or 0 in case of a memory error.
+ */
+static uint32_t reserve_player_field(gamma_t* g, uint32_t player)
+{
+    player_table* t = &g->players;
+    uint32_t r = player_table_add(t, player);
+    if(r == 0 || t->occupied_fields[r] >= UINT32_MAX) return 0;
+    if(!make_room((void**) &t->fields[r], &t->fields_capacity[r], t->occupied_fields[r], sizeof(uint64_t)))
+    {
+        return 0;
+    }
+    if(t->occupied_fields[r] != 0) return r;
+    if(!make_room((void**) &g->active_players, &g->active_capacity, g->n_of_active, sizeof(uint32_t)))
+    {
+        return 0;
+    }
+    return r;
+}
+
+/** Makes sure the list of the areas of a player has room for a given number of new areas.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] r - number of the record of the player,
+ * @param[in] n - number of the new areas.
+ * @return True, if there is enough room, and false in case of a memory error.
+ */
+static bool reserve_player_areas(gamma_t* g, uint32_t r, unsigned int n)
+{
+    player_table* t = &g->players;
+    while(t->areas_capacity[r] < (uint64_t) t->occupied_areas[r] + n)
+    {
+        if(!make_room((void**) &t->areas[r], &t->areas_capacity[r], t->areas_capacity[r], sizeof(uint32_t)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Adds a field to the index of the fields of a player and increases the number of fields
+ * occupied by them. Requires a successful call of @ref reserve_player_field beforehand.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] player - player number, positive integer not bigger than the value of
+ *                     @p players from the function @ref gamma_new,
+ * @param[in] field - index of the field.
+ */
+static void index_player_field(gamma_t* g, uint32_t player, uint64_t field)
+{
+    player_table* t = &g->players;
+    uint32_t r = player_record(g, player);
+    if(t->occupied_fields[r] == 0)
+    {
+        t->active_position[r] = g->n_of_active;
+        g->active_players[g->n_of_active++] = player;
+    }
+    *field_position(g, field) = t->occupied_fields[r];
+    t->fields[r][t->occupied_fields[r]++] = field;
+}
+
+/** Removes a field from the index of the fields of a player, by moving the last field of the
+ * index into its place, and decreases the number of fields occupied by the player.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] player - player number, positive integer not bigger than the value of
+ *                     @p players from the function @ref gamma_new,
+ * @param[in] field - index of the field.
+ */
+static void unindex_player_field(gamma_t* g, uint32_t player, uint64_t field)
+{
+    player_table* t = &g->players;
+    uint32_t r = player_record(g, player);
+    uint32_t position = *field_position(g, field);
+    uint64_t last = t->fields[r][--t->occupied_fields[r]];
+    t->fields[r][position] = last;
+    *field_position(g, last) = position;
+    if(t->occupied_fields[r] == 0)
+    {
+        uint32_t moved = g->active_players[--g->n_of_active];
+        g->active_players[t->active_position[r]] = moved;
+        t->active_position[player_record(g, moved)] = t->active_position[r];
+    }
+}
+
+/** Checks if a field is adjacent to a field of a given player.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field,
+ * @param[in] player - player number, positive integer.
+ * @return True, if one of the adjacent fields belongs to the player, and false otherwise.
+ */
+static bool adjacent_owned(gamma_t* g, uint64_t i, uint32_t player)
+{
+    return owned_by(g, neighbour(g, i, 0), player) ||
+           owned_by(g, neighbour(g, i, 1), player) ||
+           owned_by(g, neighbour(g, i, 2), player) ||
+           owned_by(g, neighbour(g, i, 3), player);
+}
+
+/** @brief Changes the owner of a field and updates the numbers of free fields
+ * adjacent to the players.
+ * Only the field itself and its adjacent fields are examined. The field stops being a free field
+ * adjacent to its neighbours, if it was free. Every free adjacent field may become
+ * adjacent to the new owner and stop being adjacent to the previous one.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] i - index of the field,
+ * @param[in] prev_owner_num - number of the previous owner of the field, or 0, if it was free,
+ * @param[in] player - number of the new owner, positive integer not bigger than the value of
+ *                     @p players from the function @ref gamma_new.
+ */
+static void set_owner(gamma_t* g, uint64_t i, uint32_t prev_owner_num, uint32_t player)
+{
+    uint64_t free_fields[4];
+    bool adjacent_before[4];
+    uint32_t owners[4];
+    unsigned int n_of_free = 0, n_of_owners = 0;
+    for(unsigned int d = 0; d < 4; d++)
+    {
+        uint64_t next = neighbour(g, i, d);
+        if(is_liberty(g, next))
+        {
+            free_fields[n_of_free] = next;
+            adjacent_before[n_of_free] = adjacent_owned(g, next, player);
+            n_of_free++;
+        }
+        else if(prev_owner_num == 0)
+        {
+            uint32_t owner = owner_of(g, next);
+            if(owner == 0) continue; // the border
+            bool counted = false;
+            for(unsigned int k = 0; k < n_of_owners; k++) counted |= owners[k] == owner;
+            if(!counted) owners[n_of_owners++] = owner;
+        }
+    }
+    for(unsigned int k = 0; k < n_of_owners; k++) g->players.frontier_fields[player_record(g, owners[k])] -= 1;
+    set_cell(g, i, player);
+    uint32_t r = player_record(g, player);
+    uint32_t prev_r = prev_owner_num != 0 ? player_record(g, prev_owner_num) : 0;
+    for(unsigned int k = 0; k < n_of_free; k++)
+    {
+        if(!adjacent_before[k]) g->players.frontier_fields[r] += 1;
+        if(prev_owner_num != 0 && !adjacent_owned(g, free_fields[k], prev_owner_num))
+        {
+            g->players.frontier_fields[prev_r] -= 1;
+        }
+    }
+}
+/** Auxiliary function of @ref gamma_move, setting a player's checker on a
+ * given field and changing the value of the number of free fields and the fields occupied
+ * by the player. Requires a successful call of @ref reserve_player_field beforehand.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] x - the column number, non-negative integer smaller than the value of
+ *                @p width from the function @ref gamma_new,
+ * @param[in] y - the row number, non-negative integer smaller than the value of
+ *                @p height from the function @ref gamma_new,
+ * @param[in] player  - player number, positive integer not bigger than the value of
+ *                      @p players from the function @ref gamma_new.
  */
-static uint32_t** new_board(uint32_t width, uint32_t height)
+static void add_field(gamma_t* g, uint32_t x, uint32_t y, uint32_t player)
 {
-    uint32_t** board = malloc(width*sizeof(uint32_t*));
-    if(board == NULL) return NULL;
-    for(uint32_t i = 0; i < width; i++)
-    {
-        uint32_t* new_column = malloc(height*sizeof(uint32_t));
-        if(new_column == NULL)
-        {
-            for(uint32_t j = 0; j < i; j++) free(board[j]);
-            free(board);
-            return NULL;
-        }
-        for(uint32_t j = 0; j < height; j++)
-        {
-            new_column[j] = 0;
-        }
-        board[i] = new_column;
-    }
-    return board;
+    uint64_t i = field_index(g, x, y);
+    mark_occupied(g, i);
+    if(g->row_occupied != NULL) g->row_occupied[y] += 1;
+    index_player_field(g, player, i);
+    set_owner(g, i, 0, player);
+    g->free_fields -= 1;
 }
 
-/** @brief Creates an auxiliary board.
- * @param[in] width - number of columns, positive integer,
- * @param[in] height - number of rowsy, positive integer.
- * @return pointer to the allocated array.
+/** Initializes an empty forest of area labels, with the labels of the searches, see @ref SEARCH_LABEL.
+ * @param[out] f - pointer to the initialized forest.
+ * @return True, if the initialization succeeded, and false in case of a memory error.
  */
-static bool** new_auxiliary(uint32_t width, uint32_t height)
+static bool new_area_forest(area_forest* f)
 {
-    bool** auxiliary = malloc(width*sizeof(bool*));
-    if(auxiliary == NULL) return NULL;
-    for(unsigned int i = 0; i < width; i++)
+    if(!area_forest_init(f)) return false;
+    for(unsigned int i = 0; i < MAX_SEARCHES; i++)
     {
-        bool* new_column = calloc(height, sizeof(bool));
-        if (new_column == NULL)
+        if(area_new(f) != SEARCH_LABEL(i))
         {
-            for(uint32_t j = 0; j < i; j++) free(auxiliary[j]);
-            free(auxiliary);
-            return NULL;
+            area_forest_free(f);
+            return false;
         }
-        auxiliary[i] = new_column;
     }
-    return auxiliary;
+    return true;
 }
 
-/** Frees the array of players.
- * @param[in] target - pointer to the array of players.
- * @param[in] size - the size of the array.
+/** Finds the root of the tree of a local label of a stripe, halving the path on the way.
+ * @param[in, out] s - pointer to the stripe,
+ * @param[in] label - a local label of the stripe.
+ * @return The root of the tree containing @p label.
  */
-static void free_array_of_players(player_t** target, uint32_t size)
+static uint32_t stripe_find(labelling_stripe* s, uint32_t label)
 {
-    if(target == NULL) return;
-    for(uint32_t i = 0; i < size; i++)
+    while(s->parent[label] != label)
     {
-        player_t* p = target[i];
-        free(p);
-        target[i] = NULL;
+        s->parent[label] = s->parent[s->parent[label]];
+        label = s->parent[label];
     }
+    return label;
 }
 
-/** Frees the board.
- * @param[in] board - pointer to the array storing the board state.
- * @param[in] width - number of the columns of the array.
+/** Joins the trees with the given roots of local labels of a stripe, making the smaller
+ * root the parent of the bigger one.
+ * @param[in, out] s - pointer to the stripe,
+ * @param[in] a - root of the first tree, or @ref NO_AREA,
+ * @param[in] b - root of the second tree.
+ * @return The root of the joined tree.
  */
-static void free_board(uint32_t** board, uint32_t width)
+static uint32_t stripe_union(labelling_stripe* s, uint32_t a, uint32_t b)
 {
-    if(board == NULL) return;
-    for(uint32_t i = 0; i < width; i++)
+    if(a == NO_AREA || a == b) return b;
+    if(b < a)
     {
-        free(board[i]);
+        uint32_t swapped = a;
+        a = b;
+        b = swapped;
     }
+    s->parent[b] = a;
+    s->size[a] += s->size[b];
+    area_box_join(&s->box[a], &s->box[b]);
+    return a;
 }
 
-/** Frees the auxiliary array.
- * @param[in] target - pointer to the auxiliary array.
- * @param[in] width - number of the array's columns.
+/** Creates a new local label of a stripe, being a root of its own one-element tree.
+ * @param[in, out] s - pointer to the stripe,
+ * @param[in] owner - number of the player owning the fields of the label.
+ * @return The new label, or @ref NO_AREA in case of a memory error.
  */
-static void free_array_of_bools(bool** target, uint32_t width)
+static uint32_t stripe_label(labelling_stripe* s, uint32_t owner)
 {
-    if(target == NULL) return;
-    for(uint32_t i = 0; i < width; i++)
+    if(s->n_of_labels >= UINT32_MAX) return NO_AREA;
+    if(s->n_of_labels >= s->capacity)
     {
-        bool* b = target[i];
-        free(b);
-        target[i] = NULL;
+        uint64_t new_capacity = s->capacity == 0 ? 1024 : 2 * s->capacity;
+        uint32_t* new_parent = realloc(s->parent, new_capacity * sizeof(uint32_t));
+        if(new_parent == NULL) return NO_AREA;
+        s->parent = new_parent;
+        uint32_t* new_owner = realloc(s->owner, new_capacity * sizeof(uint32_t));
+        if(new_owner == NULL) return NO_AREA;
+        s->owner = new_owner;
+        uint64_t* new_size = realloc(s->size, new_capacity * sizeof(uint64_t));
+        if(new_size == NULL) return NO_AREA;
+        s->size = new_size;
+        area_box* new_box = realloc(s->box, new_capacity * sizeof(area_box));
+        if(new_box == NULL) return NO_AREA;
+        s->box = new_box;
+        s->capacity = new_capacity;
     }
+    uint32_t label = (uint32_t) s->n_of_labels++;
+    s->parent[label] = label;
+    s->owner[label] = owner;
+    s->size[label] = 0;
+    s->box[label] = (area_box) {UINT32_MAX, UINT32_MAX, 0, 0};
+    return label;
 }
 
-/** @brief Clears the auxiliary array.
- * @param[in, out] g - pointer to the struct storing the game state.
+/** Numbers the components of a stripe and makes every local label point directly at its root.
+ * A single pass in increasing order is enough, because the parent of a label is smaller than it.
+ * @param[in, out] s - pointer to the stripe, with all of its fields labelled.
+ * @return True, if the components have been numbered, and false in case of a memory error.
  */
-static void clear_aux(gamma_t* g)
+static bool number_components(labelling_stripe* s)
 {
-    uint32_t width = g->width_x;
-    uint32_t height = g->height_y;
-    bool** target = g->auxiliary;
-    for(uint32_t i = 0; i < width; i++)
+    s->component = malloc((s->n_of_labels + 1) * sizeof(uint32_t));
+    if(s->component == NULL) return false;
+    for(uint64_t label = 1; label < s->n_of_labels; label++)
     {
-        for(uint32_t j = 0; j < height; j++) target[i][j] = 0;
+        if(s->parent[label] == label) s->component[label] = (uint32_t) s->n_of_components++;
+        else s->parent[label] = s->parent[s->parent[label]];
     }
+    return true;
 }
 
-/** Checks if the field with coefficients x, y should be inserted into the queue
- * for the BFS algorithm seeking a path of adjacent fields belonging to a given player.
- * The result is positive if the player own the field and it has not yet been put in the BFS
- * queue, which is checked with help of the auxiliary array.
+/** Returns the first column of a row, starting from a given one, whose field lies in a tile
+ * of the board already allocated. The fields of the other tiles are all free, so the passes
+ * of @ref gamma_rebuild_areas skip them.
  * @param[in] g - pointer to the struct storing the game state,
- * @param[in] x - the column number, non-negative integer smaller than the value of @p width
-                  from the function @ref gamma_new,
- * @param[in] y - the row number, non-negative integer smaller than the value of @p height
-                  from the function @ref gamma_new,
- * @param[in] player - player number, positive integer not bigger than the value of
- *                     @p players from the function @ref gamma_new.
- * @return True, if the field should be inserted into the queue, and false
- *         otherwise.
+ * @param[in] x - the column number to start from,
+ * @param[in] y - the row number.
+ * @return The column number, or the value of @p width from the function @ref gamma_new,
+ * if there is no such column.
  */
-static bool field_eligible(gamma_t* g, uint32_t x, uint32_t y, uint32_t player)
+static uint32_t allocated_column(gamma_t* g, uint32_t x, uint32_t y)
 {
-    if(g->auxiliary[x][y] == 1) return false;
-    if(g->board[x][y] != player) return false;
-    return true;
+    while(x < g->width_x && !tiled_array_allocated(&g->board, field_index(g, x, y)))
+    {
+        x = tile_run_end(g, x, y);
+    }
+    return x;
 }
 
-/** Auxiliart function for ther function @ref reachable, using the BFS algorithm.
- * @param[in] g - pointer to the struct storing the game state,
- * @param[in] q- pointer to the queue for performing the algorithm,
- * @param[in] x - the column number of the target field,, non-negative integer equal to the value of
- *                @p x2 from the function @ref reachable,
- * @param[in] y - the row number of the target field,, non-negative integer equal to the value of
- *                @p y2 from the function @ref reachable,
- * @param[in] player  - player number, positive integer equal to the value of @p player from the
- *                      function @ref reachable,
- * @return True, if the path sought for by the function @ref reachable
- * exists, and false otherwise.
- */
-static bool reachable_aux(gamma_t* g, queue* q, uint32_t x, uint32_t y, uint32_t player)
+/** @brief The first pass of @ref gamma_rebuild_areas, run by one thread for one stripe.
+ * Gives every occupied field of the stripe a local label, joining it with the labels of its left
+ * and lower neighbours of the same owner, the lower one only if it lies in the stripe,
+ * and then numbers the components of the stripe. Only the local labels of the last two rows
+ * are kept, and those of the first and the last row of the stripe are saved for
+ * @ref merge_stripes, so the pass changes nothing in the game. The labels of the skipped
+ * free fields, see @ref allocated_column, are left as they were, as no field joins with them.
+ * @param[in, out] arg - pointer to the stripe.
+ * @return NULL.
+ */
+static void* label_stripe(void* arg)
 {
-    while(!queue_empty(q))
+    labelling_stripe* s = arg;
+    gamma_t* g = s->g;
+    uint64_t width = g->width_x;
+    s->row_labels = malloc(2 * width * sizeof(uint32_t));
+    s->edge_labels = malloc(2 * width * sizeof(uint32_t));
+    if(s->row_labels == NULL || s->edge_labels == NULL)
     {
-        field_list* f = queue_pop(q);
-        if(f->width_x == x && f->height_y == y)
-        {
-            free(f);
-            return true;
-        }
-        else
+        s->failed = true;
+        return NULL;
+    }
+    for(uint32_t y = s->first_row; y < s->end_row; y++)
+    {
+        uint32_t* row = s->row_labels + y % 2 * width;
+        uint32_t* lower = s->row_labels + (y + 1) % 2 * width;
+        for(uint32_t x = allocated_column(g, 0, y); x < g->width_x; x = allocated_column(g, x + 1, y))
         {
-            uint32_t width = f->width_x;
-            uint32_t height = f->height_y;
-            g->auxiliary[width][height] = 1;
-            if(width != 0 && field_eligible(g, width-1, height, player))
-            {
-                queue_push(q, width-1, height);
-            }
-            if(height != 0 && field_eligible(g, width, height-1, player))
-            {
-                queue_push(q, width, height-1);
-            }
-            if(width != UINT32_MAX && width != g->width_x-1 && field_eligible(g, width+1, height, player))
+            uint64_t i = field_index(g, x, y);
+            uint32_t owner = owner_of(g, i);
+            if(owner == 0) continue;
+            uint32_t label = NO_AREA;
+            if(owner_of(g, neighbour(g, i, 0)) == owner) label = stripe_find(s, row[x - 1]);
+            if(y > s->first_row && owner_of(g, neighbour(g, i, 1)) == owner)
             {
-                queue_push(q, width+1, height);
+                label = stripe_union(s, label, stripe_find(s, lower[x]));
             }
-            if(height != UINT32_MAX && height != g->height_y -1 && field_eligible(g, width, height+1, player))
+            if(label == NO_AREA && (label = stripe_label(s, owner)) == NO_AREA)
             {
-                queue_push(q, width, height+1);
+                s->failed = true;
+                return NULL;
             }
-            free(f);
+            s->size[label] += 1;
+            area_box_extend(&s->box[label], x, y);
+            row[x] = label;
         }
+        if(y == s->first_row) memcpy(s->edge_labels, row, width * sizeof(uint32_t));
+        if(y == s->end_row - 1) memcpy(s->edge_labels + width, row, width * sizeof(uint32_t));
     }
-    return false;
+    s->failed = !number_components(s);
+    return NULL;
 }
 
-/** @brief Checks if two fields can be reached from one another through a path of adjacent fields
- * belonging to one player. 
- * @param[in,out] g -pointer to the struct storing the game state,
- * @param[in] x1 - the column number of the first field, non-negative integer smaller than the value of
- *                 @p width from the function @ref gamma_new,
- * @param[in] y1 - the row number of the first field, non-negative integer smaller than the value of
- *                 @p width from the function @ref gamma_new,
- * @param[in] x2 - the column number of the second field, non-negative integer smaller than the value of
- *                 @p width from the function @ref gamma_new,
- * @param[in] y2 - the row number of the second field, non-negative integer smaller than the value of
- *                 @p width from the function @ref gamma_new,
- * @param[in] player  - player number, positive integer not bigger than the value of
- *                      @p players from the function @ref gamma_new.
- * @return True, if such a path exists, and false otherwise.
+/** Returns the number of the component of a local label among the components of all
+ * the stripes, after the first pass of @ref gamma_rebuild_areas.
+ * @param[in] s - pointer to the stripe, in which the label has been given,
+ * @param[in] label - the local label.
+ * @return The number of the component.
  */
-static bool reachable(gamma_t* g, uint32_t x1, uint32_t y1, uint32_t x2, uint32_t y2, uint32_t player)
+static uint64_t field_component(labelling_stripe* s, uint32_t label)
 {
-    queue* q = NULL;
-    queue_init(&q);
-    queue_push(q, x1, y1);
-    bool res = reachable_aux(g, q, x2, y2, player);
-    clear_aux(g);
-    queue_clear(&q);
-    return res;
+    return s->offset + s->component[s->parent[label]];
 }
 
-/** Does nothing, if on the list @p l there already is a field reachable from (x, y)
- * by a path of adjacent fields belonging to one player, otherwise appends
- * (x, y) to the beginning of that list.
- * @param[in] g - pointer to the struct storing the game state,
- * @param[in] l - pointer to pointer to the beginning od the queue,
- * @param[in] x - the column number, non-negative integer smaller than the value of
- *                 @p width from the function @ref gamma_new,
- * @param[in] y - the row number, non-negative integer smaller than the value of
- *                 @p width from the function @ref gamma_new,
- * @param[in] player  - player number, positive integer not bigger than the value of @p players from the function @ref gamma_new.
+/** @brief The second pass of @ref gamma_rebuild_areas, run by one thread for one stripe.
+ * Gives every occupied field of the stripe the area label of its component. The stripe is
+ * scanned in the order of the first pass: a field of the same owner as its left or lower
+ * neighbour in the stripe gets the label of that neighbour, and every other field has got
+ * the next local label.
+ * @param[in, out] arg - pointer to the stripe.
+ * @return NULL.
  */
-static void append_field(gamma_t* g, field_list** l, uint32_t x, uint32_t y, uint32_t player)
+static void* relabel_stripe(void* arg)
 {
-    field_list* temp = *l;
-    if(*l == NULL)
-    {
-        field_list* new_field = malloc(sizeof(field_list));
-        new_field->next = NULL;
-        new_field->width_x = x;
-        new_field->height_y = y;
-        *l = new_field;
-    }
-    else
+    labelling_stripe* s = arg;
+    gamma_t* g = s->g;
+    uint64_t width = g->width_x;
+    uint32_t next_label = 1;
+    for(uint32_t y = s->first_row; y < s->end_row; y++)
     {
-        while(*l != NULL && !reachable(g, x, y, (*l)->width_x, (*l)->height_y, player))
-        {
-            *l = (*l)->next;
-        }
-        if(*l == NULL)
+        uint32_t* row = s->row_labels + y % 2 * width;
+        uint32_t* lower = s->row_labels + (y + 1) % 2 * width;
+        for(uint32_t x = allocated_column(g, 0, y); x < g->width_x; x = allocated_column(g, x + 1, y))
         {
-            field_list* new_list = malloc(sizeof(field_list));
-            new_list->width_x = x;
-            new_list->height_y = y;
-            new_list->next = temp;
-            *l = new_list;
+            uint64_t i = field_index(g, x, y);
+            uint32_t owner = owner_of(g, i);
+            if(owner == 0) continue;
+            if(owner_of(g, neighbour(g, i, 0)) == owner) row[x] = row[x - 1];
+            else if(y > s->first_row && owner_of(g, neighbour(g, i, 1)) == owner) row[x] = lower[x];
+            else row[x] = s->final_labels[field_component(s, next_label++)];
+            *area_label(g, i) = row[x];
         }
-        else
+    }
+    return NULL;
+}
+
+/** @brief The third pass of @ref gamma_rebuild_areas, run by one thread for one stripe.
+ * Goes through the occupied fields of the stripe, skipping the tiles not allocated yet,
+ * and adds every free field adjacent to one of them to the liberties of its area, if the field
+ * is the first neighbour in that area of the free one, as in @ref count_player_liberties,
+ * so every free field is counted once for each of its areas, wherever it lies.
+ * The labels of the fields are roots after the second pass, and the counters are shared
+ * by the threads, so they are increased atomically.
+ * @param[in, out] arg - pointer to the stripe.
+ * @return NULL.
+ */
+static void* count_stripe_liberties(void* arg)
+{
+    labelling_stripe* s = arg;
+    gamma_t* g = s->g;
+    for(uint32_t y = s->first_row; y < s->end_row; y++)
+    {
+        for(uint32_t x = allocated_column(g, 0, y); x < g->width_x; x = allocated_column(g, x + 1, y))
         {
-            *l = temp;
+            uint64_t i = field_index(g, x, y);
+            uint32_t owner = owner_of(g, i);
+            if(owner == 0) continue;
+            uint32_t root = *area_label(g, i);
+            for(unsigned int d = 0; d < 4; d++)
+            {
+                uint64_t next = neighbour(g, i, d);
+                if(is_liberty(g, next) && first_neighbour_in(g, next, owner, &root, 1, next) == (d + 2) % 4)
+                {
+                    __atomic_fetch_add(&g->areas.liberties[root], 1, __ATOMIC_RELAXED);
+                }
+            }
         }
     }
+    return NULL;
 }
 
-/** Returns the length of the list @p *l and frees that list.
- * @param[in] l - pointer to pointer to the beginning od the queue.
+/** Runs a function for every stripe, each in its own thread, apart from the first one,
+ * which is run by the calling thread, as is every stripe for which a thread could not be created.
+ * @param[in, out] stripes - array of the stripes,
+ * @param[in] n - number of the stripes,
+ * @param[in] pass - the function, called with the address of a stripe.
  */
-static unsigned int field_list_length(field_list** l)
+static void run_stripes(labelling_stripe* stripes, unsigned int n, void* (*pass)(void*))
 {
-    unsigned int i = 0;
-    while(*l != NULL)
+    pthread_t threads[MAX_LABELLING_THREADS];
+    bool started[MAX_LABELLING_THREADS] = {false};
+    for(unsigned int k = 1; k < n; k++)
     {
-        i++;
-        field_list* temp = *l;
-        *l = (*l)->next;
-        free(temp);
+        started[k] = pthread_create(&threads[k], NULL, pass, &stripes[k]) == 0;
+    }
+    pass(&stripes[0]);
+    for(unsigned int k = 1; k < n; k++)
+    {
+        if(started[k]) pthread_join(threads[k], NULL);
+        else pass(&stripes[k]);
     }
-    return i;
 }
 
-/** @brief Checks, how many areas of a given player that the fields adjacent to ( @p x, @p y) belong to.
- * @param[in] g - pointer to the struct storing the game state,
- * @param[in] x - the column number, non-negative integer smaller than the value of
- *                 @p width from the function @ref gamma_new,
- * @param[in] y - the row number, non-negative integer smaller than the value of
- *                 @p width from the function @ref gamma_new,
- * @param[in] player  - player number, positive integer not bigger than the value of
- *                      @p players from the function @ref gamma_new.
- * @return The number of areas of a given player that the fields adjacent to ( @p x, @p y) belong to. 
+/** Finds the component representing the group of merged components containing a given one,
+ * halving the path on the way.
+ * @param[in, out] merged - for every component, a smaller component merged with it, or itself,
+ * @param[in] k - number of the component.
+ * @return The number of the representing component.
  */
-static unsigned int adjacent_player_areas(gamma_t* g, uint32_t x, uint32_t y, uint32_t player)
+static uint64_t merged_find(uint32_t* merged, uint64_t k)
 {
-    uint32_t** board = g->board;
-    field_list* list = NULL;
-    if(x != 0 && board[x-1][y] == player)
+    while(merged[k] != k)
     {
-        append_field(g, &list, x-1, y, player);
+        merged[k] = merged[merged[k]];
+        k = merged[k];
     }
-    if(y != 0 &&  board[x][y-1] == player)
-    {   
-        append_field(g, &list, x, y-1, player);
+    return k;
+}
+
+/** @brief Merges the components of the stripes touching across the borders of the stripes,
+ * and gives every merged group an area label in a new forest.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] stripes - array of the stripes after the first pass,
+ * @param[in] n - number of the stripes,
+ * @param[out] merged - array with room for all the components, filled with the area label
+ *                      of the group of every component,
+ * @param[in] total - number of the components,
+ * @param[out] forest - the new forest, with a root for every group, of size 0.
+ * @return True, if the forest has been created, and false in case of a memory error.
+ */
+static bool merge_stripes(gamma_t* g, labelling_stripe* stripes, unsigned int n,
+                          uint32_t* merged, uint64_t total, area_forest* forest)
+{
+    for(uint64_t k = 0; k < total; k++) merged[k] = (uint32_t) k;
+    for(unsigned int k = 1; k < n; k++)
+    {
+        labelling_stripe* upper = &stripes[k];
+        labelling_stripe* lower = &stripes[k - 1];
+        for(uint32_t x = 0; x < g->width_x; x++)
+        {
+            uint64_t i = field_index(g, x, upper->first_row);
+            uint64_t down = neighbour(g, i, 1);
+            uint32_t owner = owner_of(g, i);
+            if(owner == 0 || owner_of(g, down) != owner) continue;
+            uint64_t a = merged_find(merged, field_component(upper, upper->edge_labels[x]));
+            uint64_t b = merged_find(merged, field_component(lower, lower->edge_labels[g->width_x + x]));
+            if(a < b) merged[b] = (uint32_t) a;
+            else merged[a] = (uint32_t) b;
+        }
     }
-    if(x != UINT32_MAX && x != g->width_x - 1 && board[x+1][y] == player)
+    if(!new_area_forest(forest)) return false;
+    if(!area_forest_reserve(forest, (uint32_t) total))
     {
-        append_field(g, &list, x+1, y, player);
+        area_forest_free(forest);
+        return false;
     }
-    if(y != UINT32_MAX && y != g->height_y - 1 && board[x][y+1] == player)
+    for(uint64_t k = 0; k < total; k++)
     {
-        append_field(g, &list, x, y+1, player);
+        if(merged[k] == k) merged[k] = area_new(forest);
+        else merged[k] = merged[merged[k]];
     }
-    return field_list_length(&list);
+    return true;
 }
 
-/** Returns the number of free fields on the board, adjacent to at least one field
- * belonging to a given player.
- * @param[in] g   - pointer to the struct storing the game state,
- * @param[in] player  - player number, positive integer not bigger than the value of
- *                      @p players from the function @ref gamma_new.
- * @return The number of free fields on the board, adjacent to at least one field
- * belonging to a given player.
+/** @brief Sums up the sizes and the boxes of the areas found by @ref gamma_rebuild_areas
+ * in a new forest, and makes sure the list of the areas of every player has room for all
+ * of their new areas, so that nothing can fail after the forest of the game is replaced.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in] stripes - array of the labelled stripes,
+ * @param[in] n - number of the stripes,
+ * @param[in] merged - area label of every component of all the stripes, see @ref merge_stripes,
+ * @param[in, out] forest - the new forest, with a label of every area, of size 0 and an empty box,
+ * @param[out] new_areas - array of zeros, one for every player occupying any fields, in the order
+ *                         of @p active_players, receiving the numbers of their new areas.
+ * @return True, if the lists have room for the areas, and false in case of a memory error.
  */
-static uint64_t fields_adjacent_to_player(gamma_t* g, uint32_t player)
+static bool gather_areas(gamma_t* g, labelling_stripe* stripes, unsigned int n, const uint32_t* merged,
+                         area_forest* forest, uint32_t* new_areas)
 {
-    uint32_t width = g->width_x;
-    uint32_t height = g->height_y;
-    uint32_t** board = g->board;
-    unsigned int res = 0;
-    for(uint32_t i = 0; i < width; i++)
+    player_table* t = &g->players;
+    for(unsigned int k = 0; k < n; k++)
     {
-        for(uint32_t j = 0; j < height; j++)
+        labelling_stripe* s = &stripes[k];
+        for(uint64_t label = 1; label < s->n_of_labels; label++)
         {
-            if(board[i][j] == 0 && adjacent_owned_by_player(g, i, j, player)) res++;
+            if(s->parent[label] != label) continue;
+            uint32_t root = merged[s->offset + s->component[label]];
+            if(forest->size[root] == 0) new_areas[t->active_position[player_record(g, s->owner[label])]]++;
+            forest->size[root] += s->size[label];
+            area_box_join(&forest->box[root], &s->box[label]);
         }
     }
-    return res;
+    for(uint32_t a = 0; a < g->n_of_active; a++)
+    {
+        uint32_t r = player_record(g, g->active_players[a]);
+        uint32_t missing = new_areas[a] > t->occupied_areas[r] ? new_areas[a] - t->occupied_areas[r] : 0;
+        if(!reserve_player_areas(g, r, missing)) return false;
+    }
+    return true;
 }
 
-/** Returns the ascii value of the digit corresponding to the number x.
- * @param[in] x - non-negative integer smaller or equal to 9.
- * @return The ascii value of the digit corresponding to the number x.
+/** Replaces the lists of the areas of the players with the areas found by
+ * @ref gamma_rebuild_areas, after the forest of the game has been replaced by the one
+ * filled by @ref gather_areas. An area is listed, when the first of its components is met;
+ * it has been met before, if it is already in the list of its owner at its position.
+ * @param[in, out] g - pointer to the struct storing the game state,
+ * @param[in, out] stripes - array of the labelled stripes, which get the final labels,
+ * @param[in] n - number of the stripes,
+ * @param[in] merged - area label of every component of all the stripes, see @ref merge_stripes.
  */
-static char number_to_digit(int x)
+static void list_rebuilt_areas(gamma_t* g, labelling_stripe* stripes, unsigned int n, const uint32_t* merged)
 {
-    return (char) x + 48;
+    player_table* t = &g->players;
+    for(uint32_t a = 0; a < g->n_of_active; a++) t->occupied_areas[player_record(g, g->active_players[a])] = 0;
+    for(unsigned int k = 0; k < n; k++)
+    {
+        labelling_stripe* s = &stripes[k];
+        for(uint64_t label = 1; label < s->n_of_labels; label++)
+        {
+            if(s->parent[label] != label) continue;
+            uint32_t root = merged[s->offset + s->component[label]];
+            uint32_t r = player_record(g, s->owner[label]);
+            uint32_t position = g->areas.position[root];
+            if(position >= t->occupied_areas[r] || t->areas[r][position] != root) list_area(g, r, root);
+        }
+        s->final_labels = merged;
+    }
 }
 
-/** @brief Writes the decimal representation of a number into an array.
- * @param[in, out] beginning - pointer to the target place in the array,
- * @param[in] total_length - the total length of the number's representation
- *                           and the preceding spaces,
- * @param[in] x - the number to be written,
- * @param[in] white - the white character appended at the end.
+/** Finds the first free field in a given row, within a given range of columns.
+ * In the Morton layout every tile is one word of the bitset of the occupied fields,
+ * and the fields of one row of a tile are ordered by their column numbers within it.
+ * @param[in] g - pointer to the struct storing the game state,
+ * @param[in] y - the row number, non-negative integer smaller than the value of
+ *                @p height from the function @ref gamma_new,
+ * @param[in] from_x - the first column number of the range,
+ * @param[in, out] x - the column number of the found field, not changed if there is none.
+ * @return True, if a free field has been found, and false otherwise.
  */
-static void write_number(char* beginning, unsigned int total_length, uint32_t x, char white)
+static bool free_field_in_row(gamma_t* g, uint32_t y, uint32_t from_x, uint32_t* x)
 {
-    if(x == 0)
+    if(g->row_occupied != NULL && g->row_occupied[y] == g->width_x) return false;
+#ifdef MORTON_LAYOUT
+    uint64_t row = (uint64_t) y + 1;
+    uint64_t row_mask = (uint64_t) 0x330033 << (dilate(row & 7) << 1);
+    for(uint64_t column = (uint64_t) from_x + 1; column <= g->width_x; column = (column | 7) + 1)
     {
-        for(unsigned int i = 0; i < total_length-1; i++) beginning[i] = ' ';
-        beginning[total_length-1] = '.';
+        uint64_t last = (column | 7) < g->width_x ? (column | 7) : g->width_x;
+        uint64_t first_bit = dilate(column & 7) | (dilate(row & 7) << 1);
+        uint64_t last_bit = dilate(last & 7) | (dilate(row & 7) << 1);
+        uint64_t range = (UINT64_MAX << first_bit) & (UINT64_MAX >> (63 - last_bit));
+        uint64_t tile = (row >> 3) * g->row_stride + ((column >> 3) << 6);
+        uint64_t free_bits = ~*bitset_word(&g->occupied_bits, tile) & row_mask & range;
+        if(free_bits != 0)
+        {
+            *x = (column & ~(uint64_t) 7) + compact(__builtin_ctzll(free_bits) & MORTON_X_BITS) - 1;
+            return true;
+        }
     }
-    else
+    return false;
+#else
+    uint64_t row_start = field_index(g, 0, y);
+    uint64_t begin = row_start + from_x;
+    uint64_t end = row_start + g->width_x;
+    while(begin < end)
     {
-        unsigned int x_length = decimal_length(x);
-        unsigned int num_of_spaces = total_length - x_length;
-        for(unsigned int i = 0; i < num_of_spaces; i++) beginning[i] = ' ';
-        for(unsigned int j = total_length-1; x > 0; j--)
+        uint64_t free_bits = ~*bitset_word(&g->occupied_bits, begin) >> (begin % 64);
+        if(free_bits != 0)
         {
-            beginning[j] = number_to_digit(x%10);
-            x /= 10;
+            uint64_t found = begin + __builtin_ctzll(free_bits);
+            if(found >= end) return false;
+            *x = found - row_start;
+            return true;
         }
+        begin = (begin / 64 + 1) * 64;
     }
-    beginning[total_length] = white;
+    return false;
+#endif
 }
 
-/** Creates the string storing the board state in case
- * not all player numbers are single-digit numbers.
- @param[in] g - pointer to the struct storing the game state,
- @param[in] max_digits - maximal length of the representation of a player number.
- @return pointer to the resulting buffer.
- */
-static char* fill_buffer_with_spaces(gamma_t* g, unsigned int max_digits)
+bool next_free_field(gamma_t *g, uint32_t *x, uint32_t *y)
 {
-    char* buffer = malloc(((max_digits+1)*g->width_x* (uint64_t) g->height_y + 1)*sizeof(char));
-    char* result = buffer;
-    if(buffer == NULL) return NULL;
-    uint32_t** board = g->board;
-    uint32_t width = g->width_x;
-    for(uint32_t y = g->height_y; y > 0; y--)
+    if(g->free_fields == 0) return false;
+    uint32_t row = *y;
+    if(*x != g->width_x - 1 && free_field_in_row(g, row, *x + 1, x)) return true;
+    for(uint32_t i = 0; i < g->height_y; i++)
     {
-        for(uint32_t x = 0; x < width-1; x++)
+        row = (row == 0) ? g->height_y - 1 : row - 1;
+        if(free_field_in_row(g, row, 0, x))
         {
-            write_number(buffer, max_digits, board[x][y-1], ' ');
-            buffer += max_digits + 1;
+            *y = row;
+            return true;
         }
-        write_number(buffer, max_digits, board[width-1][y-1], '\n');
-        buffer += max_digits + 1;
     }
-    buffer[0] = '\0';
-    return result;
+    return false;
 }
 
-/** @brief Creates the string storing the board state in case
- * all player numbers are single-digit numbers. Fields are not
- * separated by spaces in this case.
- @param[in] g - pointer to the struct storing the game state,
- @return pointer to the resulting buffer.
+bool adjacent_owned_by_player(gamma_t *g, uint32_t x, uint32_t y, uint32_t player)
+{
+    return adjacent_owned(g, field_index(g, x, y), player);
+}
+uint32_t player_areas(gamma_t* g, uint32_t player)
+{
+    return g->players.occupied_areas[player_record(g, player)];
+}
+
+bool golden_move_performed(gamma_t* g, uint32_t player)
+{
+    return player_flag(g->players.golden_performed, player_record(g, player));
+}
+
+uint32_t gamma_area_id(gamma_t *g, uint32_t x, uint32_t y)
+{
+    if(g == NULL || x >= g->width_x || y >= g->height_y) return NO_AREA;
+    uint64_t i = field_index(g, x, y);
+    if(owner_of(g, i) == 0) return NO_AREA;
+    return area_find(&g->areas, *area_label(g, i));
+}
+
+uint32_t gamma_area_sizes(gamma_t *g, uint32_t player, uint32_t *areas, uint64_t *sizes)
+{
+    if(g == NULL || player == 0 || player > g->n_of_players) return 0;
+    player_table* t = &g->players;
+    uint32_t r = player_record(g, player);
+    for(uint32_t k = 0; k < t->occupied_areas[r]; k++)
+    {
+        uint32_t root = t->areas[r][k];
+        if(areas != NULL) areas[k] = root;
+        if(sizes != NULL) sizes[k] = g->areas.size[root];
+    }
+    return t->occupied_areas[r];
+}
+
+/** Chooses the number of threads of @ref gamma_rebuild_areas: one for every processor,
+ * but no more than the number of rows and leaving at least @ref MIN_STRIPE_FIELDS fields
+ * to every thread.
+ * @param[in] g - pointer to the struct storing the game state.
+ * @return The number of threads, between 1 and @ref MAX_LABELLING_THREADS.
  */
-static char* fill_buffer_without_spaces(gamma_t* g)
+static unsigned int labelling_threads(gamma_t* g)
 {
-    char* buffer = malloc(((g->width_x + 1) * (uint64_t) g->height_y + 1)* sizeof(char));
-    char* result = buffer;
-    if(buffer == NULL) return NULL;
-    uint32_t** board = g->board;
-    uint32_t width = g->width_x;
-    unsigned int owner_num;
-    for(uint32_t y = g->height_y; y > 0; y--)
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t n = processors < 1 ? 1 : (uint64_t) processors;
+    uint64_t fields = (uint64_t) g->width_x * g->height_y;
+    if(n > MAX_LABELLING_THREADS) n = MAX_LABELLING_THREADS;
+    if(n > g->height_y) n = g->height_y;
+    if(n > fields / MIN_STRIPE_FIELDS) n = fields / MIN_STRIPE_FIELDS;
+    return n == 0 ? 1 : (unsigned int) n;
+}
+
+bool gamma_rebuild_areas(gamma_t *g)
+{
+    if(g == NULL) return false;
+    unsigned int n = labelling_threads(g);
+    labelling_stripe stripes[MAX_LABELLING_THREADS];
+    memset(stripes, 0, sizeof(stripes));
+    for(unsigned int k = 0; k < n; k++)
     {
-        for(uint32_t x = 0; x < width; x++)
+        stripes[k].g = g;
+        stripes[k].first_row = (uint32_t) ((uint64_t) g->height_y * k / n);
+        stripes[k].end_row = (uint32_t) ((uint64_t) g->height_y * (k + 1) / n);
+        stripes[k].n_of_labels = 1;
+    }
+    run_stripes(stripes, n, label_stripe);
+    bool success = true;
+    uint64_t total = 0;
+    for(unsigned int k = 0; k < n; k++)
+    {
+        success = success && !stripes[k].failed;
+        stripes[k].offset = total;
+        total += stripes[k].n_of_components;
+    }
+    uint32_t* merged = NULL;
+    area_forest forest;
+    if(success && total <= UINT32_MAX - SEARCH_LABEL(MAX_SEARCHES)) merged = malloc((total + 1) * sizeof(uint32_t));
+    success = merged != NULL && merge_stripes(g, stripes, n, merged, total, &forest);
+    if(success)
+    {
+        uint32_t* new_areas = calloc(g->n_of_active + 1, sizeof(uint32_t));
+        success = new_areas != NULL && gather_areas(g, stripes, n, merged, &forest, new_areas);
+        if(!success) area_forest_free(&forest);
+        free(new_areas);
+    }
+    if(success)
+    {
+        area_forest_free(&g->areas);
+        g->areas = forest;
+        list_rebuilt_areas(g, stripes, n, merged);
+        run_stripes(stripes, n, relabel_stripe);
+        run_stripes(stripes, n, count_stripe_liberties);
+        for(uint32_t a = 0; a < g->n_of_active; a++)
         {
-            owner_num = board[x][y-1];
-            if(owner_num != 0) buffer[0] = number_to_digit(owner_num);
-            else buffer[0] = '.';
-            buffer++;
+            set_player_flag(g->players.liberties_stale, player_record(g, g->active_players[a]), false);
         }
-        buffer[0] = '\n';
-        buffer++;
+        g->n_of_stale = 0;
+        g->modifications++;
     }
-    buffer[0] = '\0';
-    return result;
+    for(unsigned int k = 0; k < n; k++)
+    {
+        free(stripes[k].parent);
+        free(stripes[k].owner);
+        free(stripes[k].size);
+        free(stripes[k].box);
+        free(stripes[k].component);
+        free(stripes[k].row_labels);
+        free(stripes[k].edge_labels);
+    }
+    free(merged);
+    return success;
 }
 
-/** Auxiliary function of @ref gamma_move, setting a player's checker on a
- *  given field and changing the value of the number of free fields and field occupied_areas
- * by the player.
- * @param[in] g - pointer to the struct storing the game state,
- * @param[in] x - the column number, non-negative integer smaller than the value of
- *                @p width from the function @ref gamma_new,
- * @param[in] y - the row number, non-negative integer smaller than the value of
- *                @p height from the function @ref gamma_new,
- * @param[in] p - pointer to the struct storing the player,
- * @param[in] player  - player number, positive integer not bigger than the value of
- *                      @p players from the function @ref gamma_new.
- */
-static void add_field(gamma_t* g, uint32_t x, uint32_t y, player_t* p, uint32_t player)
+uint64_t gamma_area_liberties(gamma_t *g, uint32_t area)
 {
-    p->occupied_fields += 1;
-    g->board[x][y] = player;
-    g->free_fields -= 1;
+    if(g == NULL || area <= SEARCH_LABEL(MAX_SEARCHES - 1) || area >= g->areas.count) return 0;
+    if(g->areas.parent[area] != area || g->areas.size[area] == 0) return 0;
+    if(g->n_of_stale != 0) resolve_liberties(g);
+    return g->areas.liberties[area];
 }
 
-bool adjacent_owned_by_player(gamma_t *g, uint32_t x, uint32_t y, uint32_t player)
+void gamma_set_lazy_areas(gamma_t *g, bool lazy)
 {
-    uint32_t** board = g->board;
-    if(x != 0 && board[x-1][y] == player) return true;
-    if(y != 0 && board[x][y-1] == player) return true;
-    if(x != UINT32_MAX && x != g->width_x - 1 && board[x+1][y] == player) return true;
-    if(y != UINT32_MAX && y != g->height_y - 1 && board[x][y+1] == player) return true;
-    return false;;
+    if(g == NULL) return;
+    if(!lazy) resolve_liberties(g);
+    g->lazy_liberties = lazy;
+}
+
+uint32_t field_owner(gamma_t* g, uint32_t x, uint32_t y)
+{
+    return owner_of(g, field_index(g, x, y));
 }
 
 unsigned int decimal_length(uint32_t x)
@@ -563,112 +2685,157 @@ unsigned int decimal_length(uint32_t x)
     return res;
 }
 
-gamma_t* gamma_new(uint32_t width, uint32_t height, uint32_t players, uint32_t areas)
+/** Creates a structure storing the game state, see @ref gamma_new and @ref gamma_new_mapped.
+ * @param[in] width - board width, positive integer,
+ * @param[in] height - board height, positive integer,
+ * @param[in] players - number of players, positive integer,
+ * @param[in] areas - maximal number of areas of a given player, positive integer,
+ * @param[in] path - path of the file storing the arrays indexed like the board, or NULL,
+ *                   if they are to be stored in memory.
+ * @return A pointer to the created struct or NULL, if the creation failed
+ *         or one of the parameters is invalid.
+ */
+static gamma_t* new_game(uint32_t width, uint32_t height, uint32_t players, uint32_t areas, const char* path)
 {
     if(width == 0 || height == 0 || players == 0 || areas == 0) return NULL;
-    gamma_t* newgamma = malloc(sizeof(gamma_t));
+#ifdef MORTON_LAYOUT
+    uint64_t stride = (((uint64_t) width + 9) >> 3) << 6;
+    uint64_t rows = ((uint64_t) height + 9) >> 3;
+#else
+    uint64_t stride = (uint64_t) width + 1;
+    uint64_t rows = (uint64_t) height + 2;
+#endif
+    if(rows > UINT64_MAX / stride) return NULL;
+    uint64_t size = stride * rows;
+    gamma_t* newgamma = calloc(1, sizeof(gamma_t));
     if (newgamma == NULL) return NULL;
     newgamma->width_x = width;
     newgamma->height_y = height;
     newgamma->n_of_players = players;
     newgamma->n_of_areas = areas;
-    newgamma->free_fields = width*height;
-    newgamma->arr_of_players = new_arr_of_players(players);
-    if (newgamma->arr_of_players == NULL)
-    {
-        free(newgamma);
-        return NULL;
-    }
-    newgamma->board = new_board(width, height);
-    if (newgamma->board == NULL)
+    newgamma->free_fields = (uint64_t) width * height;
+    newgamma->row_stride = stride;
+    newgamma->neighbour_offsets[0] = -1;
+    newgamma->neighbour_offsets[1] = -(int64_t) stride;
+    newgamma->neighbour_offsets[2] = 1;
+    newgamma->neighbour_offsets[3] = (int64_t) stride;
+    if(width <= BITBOARD_WIDTH && height <= BITBOARD_WIDTH && players <= BITBOARD_MAX_PLAYERS)
     {
-        free_array_of_players(newgamma->arr_of_players, players);
-        free(newgamma->arr_of_players);
-        free(newgamma);
-        return NULL;
+        newgamma->player_rows = calloc((uint64_t) players * height, sizeof(uint64_t));
+        if(newgamma->player_rows == NULL)
+        {
+            gamma_delete(newgamma);
+            return NULL;
+        }
     }
-    newgamma->auxiliary = new_auxiliary(width, height);
-    if (newgamma->auxiliary == NULL)
+    if (!player_table_init(&newgamma->players, players) ||
+        !(path == NULL ? new_field_arrays(newgamma, size) : map_field_arrays(newgamma, size, path)) ||
+        !new_area_forest(&newgamma->areas))
     {
-        free_array_of_players(newgamma->arr_of_players, players);
-        free(newgamma->arr_of_players);
-        free_board(newgamma->board, width);
-        free(newgamma->board);
-        free(newgamma);
+        gamma_delete(newgamma);
         return NULL;
     }
+    if(!newgamma->sparse) mark_border(newgamma, 0, size);
     return newgamma;
 }
 
+gamma_t* gamma_new(uint32_t width, uint32_t height, uint32_t players, uint32_t areas)
+{
+    return new_game(width, height, players, areas, NULL);
+}
+
+gamma_t* gamma_new_mapped(uint32_t width, uint32_t height, uint32_t players, uint32_t areas, const char* path)
+{
+    if(path == NULL) return NULL;
+    return new_game(width, height, players, areas, path);
+}
+
 void gamma_delete(gamma_t *g)
 {
     if(g == NULL) return;
-    free_array_of_players(g->arr_of_players, g->n_of_players);
-    free(g->arr_of_players);
-    g->arr_of_players = NULL;
-    free_board(g->board, g->width_x);
-    free(g->board);
-    g->board = NULL;
-    free_array_of_bools(g->auxiliary, g->width_x);
-    free(g->auxiliary);
-    g->auxiliary = NULL;
+    player_table_free(&g->players);
+    tiled_array_free(&g->board);
+    free(g->player_rows);
+    g->player_rows = NULL;
+    tiled_array_free(&g->area_labels);
+    tiled_array_free(&g->split_parts);
+    tiled_array_free(&g->field_positions);
+    tiled_array_free(&g->occupied_bits);
+    free(g->row_occupied);
+    g->row_occupied = NULL;
+    free(g->active_players);
+    g->active_players = NULL;
+    area_forest_free(&g->areas);
+    if(g->mapping != NULL)
+    {
+        msync(g->mapping, g->mapping_bytes, MS_SYNC);
+        munmap(g->mapping, g->mapping_bytes);
+        g->mapping = NULL;
+    }
     free(g);
 }
 
+void gamma_release_workspace(void)
+{
+    workspace_free(workspace_local());
+}
+
 bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y)
 {
     if(g == NULL) return false;
     if(player == 0 || player > g->n_of_players) return false;
     if(x >= g->width_x) return false;
     if(y >= g->height_y) return false;
-    uint32_t** board = g->board;
-    if(board[x][y] != 0) return false;
-    player_t* p = g->arr_of_players[player-1];
-    unsigned int areas = adjacent_player_areas(g, x, y, player);
-    if (areas == 0) // tworzy sie nowy obszar nalezacy do gracza
+    uint64_t i = field_index(g, x, y);
+    if(owner_of(g, i) != 0) return false;
+    uint32_t roots[4];
+    unsigned int areas = adjacent_areas(g, i, player, roots);
+    if (areas == 0 && g->players.occupied_areas[player_record(g, player)] >= g->n_of_areas) // tworzy sie nowy obszar nalezacy do gracza
     {
-        if( p->occupied_areas > g->n_of_areas - 1 || g->n_of_areas == 0)
-        {
-            return false;
-        }
-        else
-        {
-            p->occupied_areas += 1;
-            add_field(g, x, y, p, player);
-            return true;
-        }
+        return false;
     }
-    else
+    workspace* w = workspace_local();
+    uint32_t r = reserve_player_field(g, player);
+    if(r == 0 || !reserve_player_areas(g, r, 1) || !reserve_field(g, i) ||
+       (areas > 1 && !g->lazy_liberties && !reserve_queue(&w->searches[0], g->players.occupied_fields[r])))
     {
-        p->occupied_areas -= areas - 1;
-        add_field(g, x, y, p, player);
-        return true;
+        return false;
+    }
+    player_table* t = &g->players;
+    bool stale = player_flag(t->liberties_stale, r) || (g->lazy_liberties && areas > 1);
+    uint64_t liberties = stale ? 0 : joined_liberties(g, w, i, player, roots, areas, true);
+    uint32_t label = join_areas(g, r, roots, areas, x, y);
+    if(label == NO_AREA) return false;
+    if(stale && !player_flag(t->liberties_stale, r))
+    {
+        set_player_flag(t->liberties_stale, r, true);
+        g->n_of_stale++;
     }
+    g->areas.liberties[label] = liberties;
+    occupy_liberty(g, i, player);
+    *area_label(g, i) = label;
+    add_field(g, x, y, player);
+    g->modifications++;
+    return true;
 }
 
-bool golden_possible_on_field(gamma_t* g, player_t* new_owner, uint32_t new_owner_num, uint32_t x, uint32_t y)
+bool golden_possible_on_field(gamma_t* g, uint32_t new_owner_num, uint32_t x, uint32_t y)
 {
-    uint32_t prev_owner_num = g->board[x][y];
+    uint64_t i = field_index(g, x, y);
+    uint32_t prev_owner_num = owner_of(g, i);
     if(prev_owner_num == 0 || prev_owner_num == new_owner_num) return false;
-    g->board[x][y]= 0;
-    unsigned int adjacent_prev_owner_areas = adjacent_player_areas(g, x, y, prev_owner_num);
-    player_t* prev_owner = g->arr_of_players[prev_owner_num-1];
-    bool disintegrating = false;
-    if(adjacent_prev_owner_areas != 0)
-        if(adjacent_prev_owner_areas - 1 > g->n_of_areas - prev_owner->occupied_areas)
-            disintegrating = true;
-    if(disintegrating)
-    {
-        g->board[x][y] = prev_owner_num;
-        return false;
-    }
-    unsigned int adjacent_new_owner_areas = adjacent_player_areas(g, x, y, new_owner_num);
-    if(adjacent_new_owner_areas == 0 && new_owner->occupied_areas == g->n_of_areas)
+    uint32_t roots[4];
+    if(adjacent_areas(g, i, new_owner_num, roots) == 0 &&
+       g->players.occupied_areas[player_record(g, new_owner_num)] == g->n_of_areas)
     {
-        g->board[x][y] = prev_owner_num;
         return false;
     }
-    g->board[x][y] = prev_owner_num;
+    uint32_t root = area_find(&g->areas, *area_label(g, i));
+    if(!g->areas.indexed[root] && !index_area(g, workspace_local(), i, root)) return false;
+    unsigned int adjacent_prev_owner_areas = *split_part(g, i);
+    if(adjacent_prev_owner_areas != 0)
+        if(adjacent_prev_owner_areas - 1 > g->n_of_areas - g->players.occupied_areas[player_record(g, prev_owner_num)])
+            return false;
     return true;
 }
 
@@ -677,35 +2844,65 @@ bool gamma_golden_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y)
     if(g==NULL) return false;
     if(player == 0 || player > g->n_of_players) return false;
     if(x >= g->width_x || y >= g->height_y) return false;
-    player_t* new_owner = g->arr_of_players[player-1];
-    if(new_owner->golden_performed == true) return false;
-    uint32_t** board = g->board;
-    uint32_t prev_owner_num = board[x][y];
+    player_table* t = &g->players;
+    if(player_flag(t->golden_performed, player_record(g, player))) return false;
+    uint64_t i = field_index(g, x, y);
+    uint32_t prev_owner_num = owner_of(g, i);
     if(prev_owner_num == 0 || prev_owner_num == player) return false;
-    player_t* prev_owner = g->arr_of_players[prev_owner_num-1];
-    board[x][y]= 0;
-    unsigned int adjacent_prev_owner_areas = adjacent_player_areas(g, x, y, prev_owner_num);
-    board[x][y] = prev_owner_num;
-    bool can_move = golden_possible_on_field(g, new_owner, player, x, y);
-    if(can_move)
-    {
-        unsigned int adjacent_new_owner_areas = adjacent_player_areas(g, x, y, player);
-        board[x][y] = player;
-        new_owner->occupied_areas -= adjacent_new_owner_areas - 1;
-        new_owner->occupied_fields += 1;
-        new_owner->golden_performed = true;
-        prev_owner->occupied_fields -= 1;
-        prev_owner->occupied_areas += adjacent_prev_owner_areas - 1;
-        return true;
+    if(!golden_possible_on_field(g, player, x, y)) return false;
+    workspace* w = workspace_local();
+    uint32_t r = reserve_player_field(g, player);
+    uint32_t prev_r = player_record(g, prev_owner_num);
+    if(r == 0 || !area_forest_reserve(&g->areas, MAX_SEARCHES + 1) ||
+       !reserve_player_areas(g, r, 1) || !reserve_player_areas(g, prev_r, MAX_SEARCHES) ||
+       !reserve_queue(&w->searches[0], t->occupied_fields[r]) ||
+       (g->player_rows != NULL && !reserve_rows(w, (uint64_t) MAX_SEARCHES * g->height_y)))
+    {
+        return false;
+    }
+    if(player_flag(t->liberties_stale, r)) count_player_liberties(g, player);
+    if(player_flag(t->liberties_stale, prev_r)) count_player_liberties(g, prev_owner_num);
+    uint32_t root = area_find(&g->areas, *area_label(g, i));
+    uint64_t budget = g->player_rows == NULL ? split_budget(g, w, root) : 0;
+    g->areas.size[root] -= 1;
+    set_cell(g, i, 0);
+    uint64_t released = release_liberties(g, i, prev_owner_num, root);
+    unsigned int parts = 0;
+    if(g->player_rows != NULL) bitboard_split(g, w, i, prev_owner_num, root);
+    else
+    {
+        parts = split_search(g, w, i, prev_owner_num, root, budget);
+        if(parts == SPLIT_ABANDONED && budget != UINT64_MAX) parts = mask_split(g, w, i, prev_owner_num, root);
+        if(parts == SPLIT_ABANDONED && budget != UINT64_MAX)
+        {
+            parts = split_search(g, w, i, prev_owner_num, root, UINT64_MAX);
+        }
     }
-    else return false;
+    if(parts == SPLIT_ABANDONED) // the queues of the searches could not grow
+    {
+        g->areas.liberties[root] += released;
+        set_cell(g, i, prev_owner_num);
+        g->areas.size[root] += 1;
+        return false;
+    }
+    uint32_t roots[4];
+    unsigned int adjacent_new_owner_areas = adjacent_areas(g, i, player, roots);
+    set_owner(g, i, prev_owner_num, player);
+    uint64_t liberties = joined_liberties(g, w, i, player, roots, adjacent_new_owner_areas, false);
+    *area_label(g, i) = join_areas(g, r, roots, adjacent_new_owner_areas, x, y);
+    g->areas.liberties[*area_label(g, i)] = liberties;
+    unindex_player_field(g, prev_owner_num, i);
+    index_player_field(g, player, i);
+    set_player_flag(t->golden_performed, r, true);
+    g->modifications++;
+    return true;
 }
 
 uint64_t gamma_busy_fields(gamma_t *g, uint32_t player)
 {
     if (g == NULL) return 0;
     if (player > g->n_of_players || player == 0) return 0;
-    return g->arr_of_players[player-1]->occupied_fields;
+    return g->players.occupied_fields[player_record(g, player)];
 }
 
 uint64_t gamma_free_fields(gamma_t *g, uint32_t player)
@@ -713,26 +2910,44 @@ uint64_t gamma_free_fields(gamma_t *g, uint32_t player)
 
     if(g == NULL) return 0;
     if(player == 0 || player > g->n_of_players) return 0;
-    player_t* target_player = g->arr_of_players[player-1];
-    if(target_player->occupied_areas == g->n_of_areas) return fields_adjacent_to_player(g, player);
+    uint32_t r = player_record(g, player);
+    if(g->players.occupied_areas[r] == g->n_of_areas) return g->players.frontier_fields[r];
     else return g->free_fields;
 }
 
 bool gamma_golden_possible(gamma_t *g, uint32_t player)
 {
     if(g == NULL) return false;
-    if(player > g->n_of_players) return false;
-    player_t* target = g->arr_of_players[player-1];
-    uint64_t occupied_by_others = (uint64_t) g->width_x * g->height_y - g->free_fields - target->occupied_fields;
-    if(target->golden_performed || occupied_by_others == 0) return false;
-    else
+    if(player == 0 || player > g->n_of_players) return false;
+    player_table* t = &g->players;
+    uint32_t r = player_record(g, player);
+    uint64_t occupied_by_others = (uint64_t) g->width_x * g->height_y - g->free_fields - t->occupied_fields[r];
+    if(player_flag(t->golden_performed, r) || occupied_by_others == 0) return false;
+    if(t->golden_versions[r] == g->modifications + 1) return player_flag(t->golden_possible, r);
+    t->golden_versions[r] = g->modifications + 1;
+    if(player_flag(t->golden_possible, r) && golden_possible_on_field(g, player, t->witness_x[r], t->witness_y[r]))
+    {
+        return true;
+    }
+    for(uint32_t a = 0; a < g->n_of_active; a++)
     {
-        for(uint32_t i = 0; i < g->width_x; i++)
-            for(uint32_t j = 0; j < g->height_y; j++)
+        uint32_t other = g->active_players[a];
+        if(other == player) continue;
+        uint32_t other_r = player_record(g, other);
+        for(uint64_t k = 0; k < t->occupied_fields[other_r]; k++)
+        {
+            uint32_t x, y;
+            field_coordinates(g, t->fields[other_r][k], &x, &y);
+            if(golden_possible_on_field(g, player, x, y))
             {
-                if(golden_possible_on_field(g, target, player, i, j)) return true;
+                t->witness_x[r] = x;
+                t->witness_y[r] = y;
+                set_player_flag(t->golden_possible, r, true);
+                return true;
             }
+        }
     }
+    set_player_flag(t->golden_possible, r, false);
     return false;
 }
 
@@ -740,13 +2955,21 @@ char* gamma_board(gamma_t *g)
 {
     if(g == NULL) return NULL;
     unsigned int max_digits = decimal_length(g->n_of_players);
+    char* result;
+    advise_board(g, POSIX_MADV_SEQUENTIAL);
+#ifdef MORTON_LAYOUT
+    result = fill_buffer_by_tiles(g, max_digits);
+#else
     if(max_digits != 1)
     {
-        return fill_buffer_with_spaces(g, max_digits);
+        result = fill_buffer_with_spaces(g, max_digits);
     }
     else
     {
-        return fill_buffer_without_spaces(g);
+        result = fill_buffer_without_spaces(g);
     }
+#endif
+    advise_board(g, POSIX_MADV_RANDOM);
+    return result;
 }
 
@@ -26,6 +26,121 @@
  */
 bool adjacent_owned_by_player(gamma_t *g, uint32_t x, uint32_t y, uint32_t player);
 
+/** Returns the number of areas occupied by the player no. @p player.
+ * @param[in] g       - pointer to the struct storing the game state,
+ * @param[in] player  - player number, positive integer not bigger than the value of
+ *                      @p players from the function @ref gamma_new.
+ * @return The number of areas.
+ */
+uint32_t player_areas(gamma_t *g, uint32_t player);
+
+/** Checks, if the player no. @p player has performed their golden move.
+ * @param[in] g       - pointer to the struct storing the game state,
+ * @param[in] player  - player number, positive integer not bigger than the value of
+ *                      @p players from the function @ref gamma_new.
+ * @return True, if the golden move has been performed, and false otherwise.
+ */
+bool golden_move_performed(gamma_t *g, uint32_t player);
+
+/** Returns the identifier of the area containing the field ( @p x, @p y). Two fields
+ * have the same identifier if and only if they belong to the same area. The identifiers
+ * stay valid until the next move or golden move, which may join or split areas.
+ * @param[in] g       - pointer to the struct storing the game state,
+ * @param[in] x       - the column number, non-negative integer smaller than the value of
+ *                      @p width from the function @ref gamma_new,
+ * @param[in] y       - the row number, non-negative integer smaller than the value of
+ *                      @p height from the function @ref gamma_new.
+ * @return The identifier of the area, a positive integer, or 0, if the field is free
+ *         or one of the parameters is invalid.
+ */
+uint32_t gamma_area_id(gamma_t *g, uint32_t x, uint32_t y);
+
+/** Lists the areas of the player no. @p player with their sizes, in time proportional
+ * to the number of the areas.
+ * @param[in] g       - pointer to the struct storing the game state,
+ * @param[in] player  - player number, positive integer not bigger than the value of
+ *                      @p players from the function @ref gamma_new,
+ * @param[out] areas  - array with room for the identifiers of all the areas of the player,
+ *                      see @ref gamma_area_id, or NULL,
+ * @param[out] sizes  - array with room for the numbers of fields of all the areas, in the same
+ *                      order, or NULL. At most @p areas from the function @ref gamma_new
+ *                      elements are written to each of the arrays.
+ * @return The number of areas of the player, or 0, if one of the parameters is invalid.
+ */
+uint32_t gamma_area_sizes(gamma_t *g, uint32_t player, uint32_t *areas, uint64_t *sizes);
+
+/** Returns the number of liberties of an area: the free fields adjacent to at least one of its
+ * fields. The numbers are kept for all the areas through the moves and golden moves, so the call
+ * takes constant time.
+ * @param[in] g       - pointer to the struct storing the game state,
+ * @param[in] area    - identifier of the area, see @ref gamma_area_id.
+ * @return The number of liberties, or 0, if @p area does not identify a current area.
+ */
+uint64_t gamma_area_liberties(gamma_t *g, uint32_t area);
+
+/** @brief Switches the lazy counting of the liberties of the areas on or off.
+ * The numbers of areas, on which the legality of the moves depends, are always exact, as joining
+ * areas costs almost nothing. Counting the liberties of joined areas requires listing the fields
+ * of all of them but the biggest one. In the lazy mode this is skipped for every player, whose
+ * move joins areas, and their liberties are counted anew, for all of their areas at once,
+ * when they are needed: by @ref gamma_area_liberties, before a golden move changing their areas,
+ * or when the lazy mode is switched off. The results of all the functions stay the same.
+ * The mode is off in a new game.
+ * @param[in,out] g   – pointer to the struct storing the game state,
+ * @param[in] lazy    – true, to switch the lazy mode on, and false, to switch it off.
+ */
+void gamma_set_lazy_areas(gamma_t *g, bool lazy);
+
+/** @brief Rebuilds the areas of all the players from the board, as after loading a position or
+ * to check the incrementally maintained areas: the area identifiers of the fields, the sizes
+ * of the areas and the lists of the areas of every player.
+ * The board is split into stripes of rows labelled at once by several threads, in two passes:
+ * the first one finds the areas within every stripe, and the second one, run after the areas
+ * touching across the borders of the stripes have been merged, stores their final identifiers.
+ * A third pass counts the liberties of the areas, see @ref gamma_area_liberties.
+ * On a board too big for memory, stored tile by tile on the first write, the passes skip
+ * the tiles not written yet, as all of their fields are free.
+ * The identifiers given by @ref gamma_area_id before the call become invalid.
+ * @param[in,out] g   – pointer to the struct storing the game state.
+ * @return @p true, if the areas have been rebuilt, and @p false, if @p g is invalid, or in case
+ *         of a memory error, which leaves the areas as they were before the call.
+ */
+bool gamma_rebuild_areas(gamma_t *g);
+
+/** @brief Frees the scratch memory of the searches run by the calling thread.
+ * The searches of all the games take their scratch memory from a workspace of the thread calling
+ * the functions of the engine, which grows to the largest game the thread has played, instead of
+ * keeping it in every game, and is freed when the thread exits. The call frees it at once, for
+ * example after the thread has finished with a big game. The games are not affected, and
+ * the workspace is allocated again by the next function that needs it.
+ */
+void gamma_release_workspace(void);
+
+/** Returns the number of the player owning the field ( @p x, @p y).
+ * @param[in] g       - pointer to the struct storing the game state,
+ * @param[in] x       - the column number, non-negative integer smaller than the value of
+ *                      @p width from the function @ref gamma_new,
+ * @param[in] y       - the row number, non-negative integer smaller than the value of
+ *                      @p height from the function @ref gamma_new.
+ * @return The number of the player owning the field, or 0, if the field is free.
+ */
+uint32_t field_owner(gamma_t *g, uint32_t x, uint32_t y);
+
+/** Finds the next free field after ( @p x, @p y), in the order in which the fields are printed
+ * by the function @ref gamma_board, starting again from the top of the board after its end.
+ * Full rows are skipped by their counters of occupied fields and the rest is found by
+ * scanning the bitset of the occupied fields 64 fields at once.
+ * @param[in] g       - pointer to the struct storing the game state,
+ * @param[in, out] x  - the column number, non-negative integer smaller than the value of
+ *                      @p width from the function @ref gamma_new, changed to the column number of
+ *                      the found field,
+ * @param[in, out] y  - the row number, non-negative integer smaller than the value of
+ *                      @p height from the function @ref gamma_new, changed to the row number of
+ *                      the found field.
+ * @return True, if a free field has been found, and false, if there are no free fields.
+ */
+bool next_free_field(gamma_t *g, uint32_t *x, uint32_t *y);
+
 /** Determines the decimal representation length of x.
  * @param[in] x - non-negative integer.
  * @return The devimal representation length of @p x.
@@ -48,6 +163,28 @@ typedef struct gamma gamma_t;
 gamma_t* gamma_new(uint32_t width, uint32_t height,
                    uint32_t players, uint32_t areas);
 
+/** @brief Creates a structure storing the game state, with the board and the other arrays
+ * of per-field data stored in a memory mapped file instead of memory, for boards which do not fit
+ * in memory. The file begins with a header: the 8 characters "GAMMAMAP", the width, the height,
+ * the number of players, the number of bytes storing one field, 1, 2 or 4, the layout, 0 for rows
+ * and 1 for Morton tiles, and a zero, as 32-bit integers, and then the difference between
+ * the indices of vertically adjacent fields or tiles and the position of the board, as 64-bit integers,
+ * all in the byte order of the machine. The board, storing the owner of every field, or 0 for
+ * a free field, in the layout described in gamma.c, follows at that position, 4096.
+ * The file stays after @ref gamma_delete, storing the final state of the board.
+ * @param[in] width   – board width, positive integer,
+ * @param[in] height  – board height, positive integer,
+ * @param[in] players – number of players, positive integer,
+ * @param[in] areas   – maximal number of areas of a given player,
+ *                      a positive integer,
+ * @param[in] path    – path of the file, which is created, or overwritten, if it is empty or has
+ *                      been written by this function before. Other files are left untouched.
+ * @return A pointer to the created struct or NULL, if the creation failed
+ *         or one of the parameters is invalid.
+ */
+gamma_t* gamma_new_mapped(uint32_t width, uint32_t height,
+                          uint32_t players, uint32_t areas, const char* path);
+
 /** @brief Deletes the struct storing the game state.
  * @param[in] g       – pointer to the deleted struct.
  */
@@ -69,14 +206,13 @@ bool gamma_move(gamma_t *g, uint32_t player, uint32_t x, uint32_t y);
 
 /** Checks, if the given player can correctly execute a golden move on a given field.
  * @param[in] g – pointer to the struct storing the game state,
- * @param[in] new_owner - pointer to the struct storing the player,
- * @param[in] new_owner_num - number of this player, positive integer,
+ * @param[in] new_owner_num - player number, positive integer,
  * @param[in] x - the column number, non-negative integer smaller than the value of
  *                @p width from the function @ref gamma_new,
  * @param[in] y – the row number, non-negative integer smaller than the value of
  *                @p height from the function @ref gamma_new.
  * */
-bool golden_possible_on_field(gamma_t* g, player_t* new_owner, uint32_t new_owner_num, uint32_t x, uint32_t y);
+bool golden_possible_on_field(gamma_t* g, uint32_t new_owner_num, uint32_t x, uint32_t y);
 
 /** @brief Executes the golden move.
  * @param[in,out] g   – pointer to the struct storing the game state,
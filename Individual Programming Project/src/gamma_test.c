@@ -13,6 +13,7 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
@@ -63,6 +64,8 @@ static const bool test_errno = false;
 
 #define MANY_GAMES 42
 
+#define MAPPED_PATH "gamma_test.map"
+
 typedef struct {
   uint32_t width;
   uint32_t height;
@@ -744,6 +747,513 @@ static int middle_board(void) {
 }
 
 
+static int next_free(void) {
+  gamma_t *g = gamma_new(70, 4, 2, 10);
+  assert(g != NULL);
+  uint32_t x = 0, y = 3;
+
+  assert(next_free_field(g, &x, &y));
+  assert(x == 1 && y == 3);
+
+  for (uint32_t i = 0; i < 70; ++i)
+    assert(gamma_move(g, 1, i, 2));
+  for (uint32_t i = 0; i < 66; ++i)
+    assert(gamma_move(g, 2, i, 1));
+
+  x = 69, y = 3;
+  assert(next_free_field(g, &x, &y));
+  assert(x == 66 && y == 1);
+
+  x = 10, y = 1;
+  assert(next_free_field(g, &x, &y));
+  assert(x == 66 && y == 1);
+
+  x = 69, y = 0;
+  assert(next_free_field(g, &x, &y));
+  assert(x == 0 && y == 3);
+
+  assert(gamma_move(g, 1, 0, 3));
+  x = 69, y = 0;
+  assert(next_free_field(g, &x, &y));
+  assert(x == 1 && y == 3);
+
+  gamma_delete(g);
+
+  g = gamma_new(3, 2, 1, 1);
+  assert(g != NULL);
+  for (uint32_t i = 0; i < 3; ++i)
+    assert(gamma_move(g, 1, i, 0));
+  assert(gamma_move(g, 1, 0, 1));
+  assert(gamma_move(g, 1, 2, 1));
+
+  x = 1, y = 1;
+  assert(next_free_field(g, &x, &y));
+  assert(x == 1 && y == 1);
+
+  x = 2, y = 0;
+  assert(next_free_field(g, &x, &y));
+  assert(x == 1 && y == 1);
+
+  assert(gamma_move(g, 1, 1, 1));
+  x = 0, y = 0;
+  assert(!next_free_field(g, &x, &y));
+
+  gamma_delete(g);
+  return PASS;
+}
+
+static uint32_t random_below(uint64_t *state, uint32_t bound) {
+  *state = *state * 6364136223846793005u + 1442695040888963407u;
+  return (uint32_t)(*state >> 33) % bound;
+}
+
+static void play_same(gamma_t *g1, gamma_t *g2, gamma_param_t game,
+                      uint64_t *state, unsigned moves) {
+  for (unsigned i = 0; i < moves; ++i) {
+    uint32_t player = 1 + random_below(state, game.players);
+    uint32_t x = random_below(state, game.width);
+    uint32_t y = random_below(state, game.height);
+    if (random_below(state, 16) == 0)
+      assert(gamma_golden_move(g1, player, x, y) ==
+             gamma_golden_move(g2, player, x, y));
+    else
+      assert(gamma_move(g1, player, x, y) == gamma_move(g2, player, x, y));
+    assert(gamma_busy_fields(g1, player) == gamma_busy_fields(g2, player));
+    assert(gamma_free_fields(g1, player) == gamma_free_fields(g2, player));
+    assert(gamma_golden_possible(g1, player) ==
+           gamma_golden_possible(g2, player));
+  }
+  char *board1 = gamma_board(g1);
+  char *board2 = gamma_board(g2);
+  assert(board1 != NULL && board2 != NULL);
+  assert(strcmp(board1, board2) == 0);
+  free(board1);
+  free(board2);
+}
+
+
+static int mapped(void) {
+  static const gamma_param_t game = {100, 70, 3, 8};
+  remove(MAPPED_PATH);
+
+  gamma_t *g1 = gamma_new(game.width, game.height, game.players, game.areas);
+  gamma_t *g2 = gamma_new_mapped(game.width, game.height, game.players,
+                                 game.areas, MAPPED_PATH);
+  assert(g1 != NULL && g2 != NULL);
+  uint64_t state = 42;
+  play_same(g1, g2, game, &state, 20000);
+  gamma_delete(g1);
+  gamma_delete(g2);
+
+  FILE *f = fopen(MAPPED_PATH, "rb");
+  assert(f != NULL);
+  char magic[8];
+  uint32_t header[4];
+  assert(fread(magic, 1, sizeof(magic), f) == sizeof(magic));
+  assert(fread(header, sizeof(uint32_t), SIZE(header), f) == SIZE(header));
+  fclose(f);
+  assert(memcmp(magic, "GAMMAMAP", sizeof(magic)) == 0);
+  assert(header[0] == game.width && header[1] == game.height);
+  assert(header[2] == game.players && header[3] == 1);
+
+  g2 = gamma_new_mapped(2, 2, 2, 2, MAPPED_PATH);
+  assert(g2 != NULL);
+  gamma_delete(g2);
+
+  f = fopen(MAPPED_PATH, "wb");
+  assert(f != NULL);
+  fputs("not a board", f);
+  fclose(f);
+  assert(gamma_new_mapped(2, 2, 2, 2, MAPPED_PATH) == NULL);
+  char text[16] = {0};
+  f = fopen(MAPPED_PATH, "rb");
+  assert(f != NULL);
+  assert(fread(text, 1, sizeof(text) - 1, f) == strlen("not a board"));
+  fclose(f);
+  assert(strcmp(text, "not a board") == 0);
+
+  remove(MAPPED_PATH);
+  return PASS;
+}
+
+static int compare_ids(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+static void check_areas(gamma_t *g, gamma_param_t game) {
+  uint64_t fields = (uint64_t)game.width * game.height;
+  uint32_t *component = calloc(fields, sizeof(uint32_t));
+  uint64_t *stack = malloc(fields * sizeof(uint64_t));
+  uint64_t *sizes = calloc(fields + 1, sizeof(uint64_t));
+  uint32_t *ids = calloc(fields + 1, sizeof(uint32_t));
+  uint32_t *listed = malloc(game.areas * sizeof(uint32_t));
+  uint64_t *listed_sizes = malloc(game.areas * sizeof(uint64_t));
+  uint32_t *areas = calloc(game.players + 1, sizeof(uint32_t));
+  assert(component && stack && sizes && ids && listed && listed_sizes && areas);
+
+  uint32_t n = 0;
+  for (uint64_t i = 0; i < fields; ++i) {
+    uint32_t x = i % game.width, y = i / game.width;
+    uint32_t owner = field_owner(g, x, y);
+    if (owner == 0) {
+      assert(gamma_area_id(g, x, y) == 0);
+      continue;
+    }
+    if (component[i] != 0)
+      continue;
+    component[i] = ++n;
+    ids[n] = gamma_area_id(g, x, y);
+    assert(ids[n] != 0);
+    areas[owner]++;
+    uint64_t top = 0;
+    stack[top++] = i;
+    while (top > 0) {
+      uint64_t j = stack[--top];
+      uint32_t jx = j % game.width, jy = j / game.width;
+      assert(gamma_area_id(g, jx, jy) == ids[n]);
+      sizes[n]++;
+      int64_t next[4] = {jx > 0 ? (int64_t)j - 1 : -1,
+                         jx + 1 < game.width ? (int64_t)j + 1 : -1,
+                         jy > 0 ? (int64_t)(j - game.width) : -1,
+                         jy + 1 < game.height ? (int64_t)(j + game.width) : -1};
+      for (int d = 0; d < 4; ++d) {
+        if (next[d] < 0 || component[next[d]] != 0 ||
+            field_owner(g, next[d] % game.width, next[d] / game.width) != owner)
+          continue;
+        component[next[d]] = n;
+        stack[top++] = next[d];
+      }
+    }
+  }
+
+  for (uint32_t player = 1; player <= game.players; ++player) {
+    uint32_t count = gamma_area_sizes(g, player, listed, listed_sizes);
+    assert(count == areas[player]);
+    for (uint32_t k = 0; k < count; ++k) {
+      uint32_t c = 1;
+      while (c <= n && ids[c] != listed[k])
+        ++c;
+      assert(c <= n && sizes[c] == listed_sizes[k]);
+    }
+  }
+
+  qsort(ids + 1, n, sizeof(uint32_t), compare_ids);
+  for (uint32_t c = 2; c <= n; ++c)
+    assert(ids[c] != ids[c - 1]);
+
+  free(areas);
+  free(component);
+  free(stack);
+  free(sizes);
+  free(ids);
+  free(listed);
+  free(listed_sizes);
+}
+
+
+static int area_ids(void) {
+  static const gamma_param_t game[] = {
+    {12, 9, 3, 4},
+    {90, 50, 4, 12},
+  };
+  for (size_t i = 0; i < SIZE(game); ++i) {
+    for (uint64_t seed = 0; seed < 16; ++seed) {
+      gamma_t *g = gamma_new(game[i].width, game[i].height,
+                             game[i].players, game[i].areas);
+      assert(g != NULL);
+      uint64_t state = seed;
+      uint32_t fields = game[i].width * game[i].height;
+      for (unsigned move = 0; move < 2 * fields; ++move) {
+        uint32_t player = 1 + random_below(&state, game[i].players);
+        uint32_t x = random_below(&state, game[i].width);
+        uint32_t y = random_below(&state, game[i].height);
+        if (random_below(&state, 8) == 0)
+          gamma_golden_move(g, player, x, y);
+        else
+          gamma_move(g, player, x, y);
+        if (move % (fields / 32 + 1) == 0)
+          check_areas(g, game[i]);
+      }
+      check_areas(g, game[i]);
+      gamma_delete(g);
+    }
+  }
+  return PASS;
+}
+
+static int rebuild(void) {
+  static const gamma_param_t game = {200, 2000, 3, 2000};
+  gamma_t *g = gamma_new(game.width, game.height, game.players, game.areas);
+  assert(g != NULL);
+
+  for (uint32_t y = 0; y < game.height; ++y)
+    assert(gamma_move(g, 1, 100, y));
+  uint64_t state = 2020;
+  for (unsigned move = 0; move < game.width * game.height; ++move) {
+    uint32_t player = 1 + random_below(&state, game.players);
+    uint32_t x = random_below(&state, game.width);
+    uint32_t y = random_below(&state, game.height);
+    if (random_below(&state, 64) == 0)
+      gamma_golden_move(g, player, x, y);
+    else
+      gamma_move(g, player, x, y);
+  }
+  check_areas(g, game);
+
+  char *board = gamma_board(g);
+  assert(board != NULL);
+  assert(gamma_rebuild_areas(g));
+  check_areas(g, game);
+  char *rebuilt = gamma_board(g);
+  assert(rebuilt != NULL);
+  assert(strcmp(board, rebuilt) == 0);
+  free(board);
+  free(rebuilt);
+
+  for (unsigned move = 0; move < game.width * game.height / 4; ++move) {
+    uint32_t player = 1 + random_below(&state, game.players);
+    uint32_t x = random_below(&state, game.width);
+    uint32_t y = random_below(&state, game.height);
+    if (random_below(&state, 16) == 0)
+      gamma_golden_move(g, player, x, y);
+    else
+      gamma_move(g, player, x, y);
+  }
+  check_areas(g, game);
+
+  gamma_delete(g);
+  return PASS;
+}
+
+static size_t find_id(const uint32_t *sorted, size_t n, uint32_t id) {
+  size_t low = 0, high = n;
+  while (low < high) {
+    size_t middle = low + (high - low) / 2;
+    if (sorted[middle] < id)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+  return low;
+}
+
+static void check_window_liberties(gamma_t *g, gamma_param_t game,
+                                   uint32_t x0, uint32_t y0,
+                                   uint32_t width, uint32_t height) {
+  uint64_t fields = (uint64_t)width * height;
+  uint32_t *hits = malloc(4 * fields * sizeof(uint32_t));
+  assert(hits != NULL);
+
+  size_t n = 0;
+  for (uint32_t y = y0; y < y0 + height; ++y) {
+    for (uint32_t x = x0; x < x0 + width; ++x) {
+      if (field_owner(g, x, y) != 0)
+        continue;
+      uint32_t ids[4] = {
+        x > 0 ? gamma_area_id(g, x - 1, y) : 0,
+        x + 1 < game.width ? gamma_area_id(g, x + 1, y) : 0,
+        y > 0 ? gamma_area_id(g, x, y - 1) : 0,
+        y + 1 < game.height ? gamma_area_id(g, x, y + 1) : 0};
+      for (int d = 0; d < 4; ++d) {
+        bool repeated = ids[d] == 0;
+        for (int e = 0; e < d; ++e)
+          repeated |= ids[e] == ids[d];
+        if (!repeated)
+          hits[n++] = ids[d];
+      }
+    }
+  }
+  qsort(hits, n, sizeof(uint32_t), compare_ids);
+
+  for (uint32_t y = y0; y < y0 + height; ++y) {
+    for (uint32_t x = x0; x < x0 + width; ++x) {
+      uint32_t id = gamma_area_id(g, x, y);
+      if (id == 0)
+        continue;
+      size_t first = find_id(hits, n, id);
+      size_t last = find_id(hits, n, id + 1);
+      assert(gamma_area_liberties(g, id) == last - first);
+    }
+  }
+
+  free(hits);
+}
+
+static void check_liberties(gamma_t *g, gamma_param_t game) {
+  check_window_liberties(g, game, 0, 0, game.width, game.height);
+}
+
+
+static int lazy_liberties(void) {
+  static const gamma_param_t game[] = {
+    {12, 9, 3, 4},
+    {70, 20, 4, 12},
+  };
+  for (size_t i = 0; i < SIZE(game); ++i) {
+    for (uint64_t seed = 0; seed < 64; ++seed) {
+      gamma_t *lazy = gamma_new(game[i].width, game[i].height,
+                                game[i].players, game[i].areas);
+      gamma_t *eager = gamma_new(game[i].width, game[i].height,
+                                 game[i].players, game[i].areas);
+      assert(lazy != NULL && eager != NULL);
+      gamma_set_lazy_areas(lazy, true);
+      uint64_t state = seed;
+      for (unsigned round = 0; round < 32; ++round) {
+        play_same(lazy, eager, game[i], &state,
+                  game[i].width * game[i].height / 16);
+        check_liberties(eager, game[i]);
+        check_liberties(lazy, game[i]);
+      }
+      gamma_set_lazy_areas(lazy, false);
+      check_liberties(lazy, game[i]);
+      gamma_delete(lazy);
+      gamma_delete(eager);
+    }
+  }
+  return PASS;
+}
+
+static int release_workspace(void) {
+  static const gamma_param_t game = {90, 50, 4, 12};
+  gamma_release_workspace();
+  for (uint64_t seed = 0; seed < 8; ++seed) {
+    gamma_t *g1 = gamma_new(game.width, game.height, game.players, game.areas);
+    gamma_t *g2 = gamma_new(game.width, game.height, game.players, game.areas);
+    assert(g1 != NULL && g2 != NULL);
+    uint64_t state = seed;
+    for (unsigned round = 0; round < 8; ++round) {
+      play_same(g1, g2, game, &state, game.width * game.height / 4);
+      gamma_release_workspace();
+      check_areas(g1, game);
+      check_liberties(g1, game);
+      gamma_release_workspace();
+      gamma_release_workspace();
+    }
+    gamma_delete(g1);
+    gamma_delete(g2);
+  }
+  return PASS;
+}
+
+static int sparse_liberties(void) {
+  static const gamma_param_t game = {65535, 1 << 18, 3, 1 << 20};
+  static const uint32_t window[][2] = {
+    {0, 0}, {65535 - 12, (1 << 18) - 12}, {30000, 1000}, {0, 70000},
+  };
+  gamma_t *lazy = gamma_new(game.width, game.height, game.players, game.areas);
+  gamma_t *eager = gamma_new(game.width, game.height, game.players, game.areas);
+  if (lazy == NULL || eager == NULL) {
+    gamma_delete(lazy);
+    gamma_delete(eager);
+    return PASS;
+  }
+  gamma_set_lazy_areas(lazy, true);
+  uint64_t state = 65535;
+  for (size_t i = 0; i < SIZE(window); ++i) {
+    uint32_t x0 = window[i][0], y0 = window[i][1];
+    for (unsigned round = 0; round < 8; ++round) {
+      for (unsigned move = 0; move < 32; ++move) {
+        uint32_t player = 1 + random_below(&state, game.players);
+        uint32_t x = x0 + random_below(&state, 12);
+        uint32_t y = y0 + random_below(&state, 12);
+        if (random_below(&state, 16) == 0)
+          assert(gamma_golden_move(lazy, player, x, y) ==
+                 gamma_golden_move(eager, player, x, y));
+        else
+          assert(gamma_move(lazy, player, x, y) ==
+                 gamma_move(eager, player, x, y));
+      }
+      uint32_t left = x0 > 0 ? x0 - 1 : 0, bottom = y0 > 0 ? y0 - 1 : 0;
+      uint32_t right = x0 + 13 < game.width ? x0 + 13 : game.width;
+      uint32_t top = y0 + 13 < game.height ? y0 + 13 : game.height;
+      check_window_liberties(eager, game, left, bottom, right - left, top - bottom);
+      check_window_liberties(lazy, game, left, bottom, right - left, top - bottom);
+    }
+  }
+  gamma_delete(lazy);
+  gamma_delete(eager);
+  return PASS;
+}
+
+static void window_areas(gamma_t *g, gamma_param_t game,
+                         const uint32_t (*window)[2], size_t windows,
+                         uint32_t *ids, uint64_t *sizes) {
+  uint32_t *listed = malloc(game.areas * sizeof(uint32_t));
+  uint64_t *listed_sizes = malloc(game.areas * sizeof(uint64_t));
+  assert(listed != NULL && listed_sizes != NULL);
+  for (uint32_t player = 1; player <= game.players; ++player) {
+    uint32_t count = gamma_area_sizes(g, player, listed, listed_sizes);
+    size_t n = 0;
+    for (size_t i = 0; i < windows; ++i) {
+      for (uint32_t y = window[i][1]; y < window[i][1] + 12; ++y) {
+        for (uint32_t x = window[i][0]; x < window[i][0] + 12; ++x, ++n) {
+          if (field_owner(g, x, y) != player)
+            continue;
+          ids[n] = gamma_area_id(g, x, y);
+          uint32_t k = 0;
+          while (k < count && listed[k] != ids[n])
+            ++k;
+          assert(k < count);
+          sizes[n] = listed_sizes[k];
+        }
+      }
+    }
+  }
+  free(listed);
+  free(listed_sizes);
+}
+
+static int sparse_rebuild(void) {
+  static const gamma_param_t game = {65535, 1 << 18, 3, 1 << 20};
+  static const uint32_t window[][2] = {
+    {0, 0}, {65535 - 12, (1 << 18) - 12}, {8186, 5000}, {30000, 70000},
+  };
+  enum { FIELDS = SIZE(window) * 12 * 12 };
+  gamma_t *g = gamma_new(game.width, game.height, game.players, game.areas);
+  if (g == NULL)
+    return PASS;
+  uint64_t state = 2021;
+  for (unsigned round = 0; round < 2; ++round) {
+    for (size_t i = 0; i < SIZE(window); ++i) {
+      for (unsigned move = 0; move < 96; ++move) {
+        uint32_t player = 1 + random_below(&state, game.players);
+        uint32_t x = window[i][0] + random_below(&state, 12);
+        uint32_t y = window[i][1] + random_below(&state, 12);
+        if (random_below(&state, 16) == 0)
+          gamma_golden_move(g, player, x, y);
+        else
+          gamma_move(g, player, x, y);
+      }
+    }
+
+    static uint32_t ids[FIELDS], rebuilt_ids[FIELDS];
+    static uint64_t sizes[FIELDS], rebuilt_sizes[FIELDS];
+    memset(ids, 0, sizeof(ids));
+    memset(rebuilt_ids, 0, sizeof(rebuilt_ids));
+    window_areas(g, game, window, SIZE(window), ids, sizes);
+    assert(gamma_rebuild_areas(g));
+    window_areas(g, game, window, SIZE(window), rebuilt_ids, rebuilt_sizes);
+    for (size_t j = 0; j < FIELDS; ++j) {
+      assert((ids[j] == 0) == (rebuilt_ids[j] == 0));
+      if (ids[j] == 0)
+        continue;
+      assert(sizes[j] == rebuilt_sizes[j]);
+      for (size_t k = 0; k < j; ++k)
+        assert((ids[j] == ids[k]) == (rebuilt_ids[j] == rebuilt_ids[k]));
+    }
+    for (size_t i = 0; i < SIZE(window); ++i) {
+      uint32_t x0 = window[i][0], y0 = window[i][1];
+      uint32_t left = x0 > 0 ? x0 - 1 : 0, bottom = y0 > 0 ? y0 - 1 : 0;
+      uint32_t right = x0 + 13 < game.width ? x0 + 13 : game.width;
+      uint32_t top = y0 + 13 < game.height ? y0 + 13 : game.height;
+      check_window_liberties(g, game, left, bottom, right - left, top - bottom);
+    }
+  }
+  gamma_delete(g);
+  return PASS;
+}
+
 
 typedef struct {
   char const *name;
@@ -768,6 +1278,14 @@ static const test_list_t test_list[] = {
   TEST(memory_alloc),
   TEST(big_board),
   TEST(middle_board),
+  TEST(next_free),
+  TEST(mapped),
+  TEST(area_ids),
+  TEST(rebuild),
+  TEST(lazy_liberties),
+  TEST(release_workspace),
+  TEST(sparse_liberties),
+  TEST(sparse_rebuild),
 };
 
 int main(int argc, char *argv[]) {
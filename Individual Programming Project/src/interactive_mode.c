@@ -39,12 +39,11 @@ static void polish_ending_field(uint64_t n)
 static void print_prompt(gamma_t* g, uint32_t player, cursor_t* cursor)
 {
     set_cursor_to_line(g->height_y + 1);
-    player_t* prompted_player = g->arr_of_players[player-1];
     printf("Tura gracza o numerze %" PRIu32 "\n", player);
     uint64_t total_fields = g->width_x*g->height_y;
     printf("Zajete pola: %" PRIu64 "" , gamma_busy_fields(g, player));
     printf("/%" PRIu64 "\n", total_fields);
-    printf("Zajete obszary: %" PRIu32 "" , prompted_player->occupied_areas);
+    printf("Zajete obszary: %" PRIu32 "" , player_areas(g, player));
     printf("/%" PRIu32 "\n", g->n_of_areas);
     uint64_t free = gamma_free_fields(g, player);
     if(free == 0) printf("Nie ma wolnych pol, na ktore gracz moze sie ruszyc\n");
@@ -55,7 +54,7 @@ static void print_prompt(gamma_t* g, uint32_t player, cursor_t* cursor)
         polish_ending_field(free);
         printf("\n");
     }
-    if(prompted_player->golden_performed)
+    if(golden_move_performed(g, player))
     {
         printf("golden move zostal juz wykonany\n");
     }
@@ -108,9 +107,20 @@ static void execute_down_arrow(cursor_t* cursor)
     else cursor->y -= 1;
 }
 
-/** Moves the virtual cursor by one field in the given direction, provided that this is possible.
+/** Moves the virtual cursor to the next free field, in the order in which the board is printed.
+ * Does nothing, if there are no free fields.
+ * @param[in, out] cursor - pointer to the struct storing the game cursor,
+ * @param[in] g - pointer to the struct storing the game state.
+ */
+static void execute_tab(gamma_t* g, cursor_t* cursor)
+{
+    next_free_field(g, &cursor->x, &cursor->y);
+}
+
+/** Moves the virtual cursor by one field in the given direction, provided that this is possible,
+ * or to the next free field.
  * @param[in] cursor - pointer to the struct storing the game cursor,
- * @param[in] k - enum determining the pressed arrow key,
+ * @param[in] k - enum determining the pressed arrow key or tab,
  * @param[in] g - pointer to the struct storing the game state.
  */
 static void execute_arrow(gamma_t* g, enum key k, cursor_t* cursor)
@@ -132,6 +142,10 @@ static void execute_arrow(gamma_t* g, enum key k, cursor_t* cursor)
         case down:
             execute_down_arrow(cursor);
             break;
+
+        case tab:
+            execute_tab(g, cursor);
+            break;
         
         default:
             break;
@@ -155,6 +169,8 @@ static enum key without_esc(char c)
         case 67:
         case 99:
             return skip;
+        case 9:
+            return tab;
         case 32:
             return spacebar;
         case 71:
@@ -317,23 +333,22 @@ static void change_board(gamma_t* g, char* board_image, uint32_t player, cursor_
  */
 static void highlight_for_player(gamma_t* g, cursor_t* cursor, uint32_t player, char* board_image)
 {
-    player_t* current_player = g->arr_of_players[player-1];
     uint32_t cursor_x = cursor->x;
     uint32_t cursor_y = cursor->y;
     bool changed_attributes = false;
-    if(golden_possible_on_field(g, current_player, player, cursor_x, cursor_y) &&
-       !current_player->golden_performed)
+    if(golden_possible_on_field(g, player, cursor_x, cursor_y) &&
+       !golden_move_performed(g, player))
     {
         background_to_yellow();
         changed_attributes = true;
     }
-    else if(g->board[cursor_x][cursor_y] == player)
+    else if(field_owner(g, cursor_x, cursor_y) == player)
     {
         background_to_red();
         changed_attributes = true;
     }
     else if(adjacent_owned_by_player(g, cursor_x, cursor_y, player) &&
-            g->board[cursor_x][cursor_y] == 0)
+            field_owner(g, cursor_x, cursor_y) == 0)
     {
         background_to_magenta();
         changed_attributes = true;
@@ -353,19 +368,18 @@ static void highlight_for_player(gamma_t* g, cursor_t* cursor, uint32_t player,
  */
 static void reprint_field_for_player(gamma_t* g, uint32_t player, char* board_image, cursor_t* cursor)
 {
-    player_t* current_player = g->arr_of_players[player-1];
     uint32_t cursor_x = cursor->x;
     uint32_t cursor_y = cursor->y;
-    if(golden_possible_on_field(g, current_player, player, cursor->x, cursor->y))
+    if(golden_possible_on_field(g, player, cursor->x, cursor->y))
     {
-        if(!current_player->golden_performed) foreground_to_yellow();
+        if(!golden_move_performed(g, player)) foreground_to_yellow();
     }
-    else if(g->board[cursor_x][cursor_y] == player)
+    else if(field_owner(g, cursor_x, cursor_y) == player)
     {
         foreground_to_red();
     }
     else if(adjacent_owned_by_player(g, cursor_x, cursor_y, player) &&
-            g->board[cursor_x][cursor_y] == 0)
+            field_owner(g, cursor_x, cursor_y) == 0)
     {
         foreground_to_magenta();
     }
@@ -412,13 +426,13 @@ static void show_board_for_player(gamma_t* g, uint32_t player, char* board_image
 }
 
 
-/** Determines if a key is an arrow key.
+/** Determines if a key moves the cursor, that is if it is an arrow key or tab.
  * @param[in] k - enum determining the key.
- * @return true, if the key is an arrow, and false otherwise.
+ * @return true, if the key moves the cursor, and false otherwise.
  */
 static bool is_arrow(enum key k)
 {
-    return k == left || k == right || k == up || k == down;
+    return k == left || k == right || k == up || k == down || k == tab;
 }
 
 /** Determines if the key is executable by the program.
@@ -0,0 +1,216 @@
+/** @file
+ * Implementation of the table of the players of a game.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "player_table.h"
+
+/** Number of players, for whom a record is materialized on their first move, rather than
+ * when the game is created.
+ */
+#define LAZY_PLAYERS_FROM (1 << 16)
+
+/** Number of records allocated at first, if they are materialized on the first move.
+ */
+#define INITIAL_CAPACITY 64
+
+/** Returns the number of bytes of all the arrays of a table with room for a given number
+ * of records.
+ * @param[in] n - number of records.
+ * @return The number of bytes.
+ */
+static uint64_t table_bytes(uint64_t n)
+{
+    return n * (7 * sizeof(uint64_t) + 4 * sizeof(uint32_t)) + 3 * (n / 64 + 1) * sizeof(uint64_t);
+}
+
+/** Sets the arrays of a table to consecutive parts of a block of memory.
+ * @param[out] t - pointer to the table,
+ * @param[in] block - the memory, of @ref table_bytes bytes,
+ * @param[in] n - number of records.
+ */
+static void carve(player_table* t, void* block, uint64_t n)
+{
+    uint64_t words = n / 64 + 1;
+    t->block = block;
+    t->occupied_fields = block;
+    t->frontier_fields = t->occupied_fields + n;
+    t->golden_versions = t->frontier_fields + n;
+    t->fields_capacity = t->golden_versions + n;
+    t->fields = (uint64_t**) (t->fields_capacity + n);
+    t->areas_capacity = (uint64_t*) (t->fields + n);
+    t->areas = (uint32_t**) (t->areas_capacity + n);
+    t->golden_performed = (uint64_t*) (t->areas + n);
+    t->golden_possible = t->golden_performed + words;
+    t->liberties_stale = t->golden_possible + words;
+    t->occupied_areas = (uint32_t*) (t->liberties_stale + words);
+    t->witness_x = t->occupied_areas + n;
+    t->witness_y = t->witness_x + n;
+    t->active_position = t->witness_y + n;
+    t->capacity = n;
+}
+
+/** Moves the records of a table into a new block of memory with room for more records.
+ * @param[in, out] t - pointer to the table.
+ * @return true, if the table has grown, and false in case of a memory error.
+ */
+static bool grow_records(player_table* t)
+{
+    uint64_t n = 2 * t->capacity;
+    void* block = calloc(1, table_bytes(n));
+    if(block == NULL) return false;
+    player_table old = *t;
+    uint64_t words = old.count / 64 + 1;
+    carve(t, block, n);
+    memcpy(t->occupied_fields, old.occupied_fields, old.count * sizeof(uint64_t));
+    memcpy(t->frontier_fields, old.frontier_fields, old.count * sizeof(uint64_t));
+    memcpy(t->golden_versions, old.golden_versions, old.count * sizeof(uint64_t));
+    memcpy(t->fields_capacity, old.fields_capacity, old.count * sizeof(uint64_t));
+    memcpy(t->fields, old.fields, old.count * sizeof(uint64_t*));
+    memcpy(t->areas_capacity, old.areas_capacity, old.count * sizeof(uint64_t));
+    memcpy(t->areas, old.areas, old.count * sizeof(uint32_t*));
+    memcpy(t->golden_performed, old.golden_performed, words * sizeof(uint64_t));
+    memcpy(t->golden_possible, old.golden_possible, words * sizeof(uint64_t));
+    memcpy(t->liberties_stale, old.liberties_stale, words * sizeof(uint64_t));
+    memcpy(t->occupied_areas, old.occupied_areas, old.count * sizeof(uint32_t));
+    memcpy(t->witness_x, old.witness_x, old.count * sizeof(uint32_t));
+    memcpy(t->witness_y, old.witness_y, old.count * sizeof(uint32_t));
+    memcpy(t->active_position, old.active_position, old.count * sizeof(uint32_t));
+    free(old.block);
+    return true;
+}
+
+/** Returns the position in the hash map, at which the search for a player starts.
+ * @param[in] t - pointer to the table,
+ * @param[in] player - player number, positive integer.
+ * @return The position.
+ */
+static uint64_t map_start(const player_table* t, uint32_t player)
+{
+    return ((player * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & (t->map_capacity - 1);
+}
+
+/** Inserts a player into the hash map, which must have a free place.
+ * @param[in, out] t - pointer to the table,
+ * @param[in] player - player number, positive integer,
+ * @param[in] record - number of the record of the player.
+ */
+static void map_insert(player_table* t, uint32_t player, uint32_t record)
+{
+    uint64_t i = map_start(t, player);
+    while(t->map_players[i] != 0) i = (i + 1) & (t->map_capacity - 1);
+    t->map_players[i] = player;
+    t->map_records[i] = record;
+}
+
+/** Doubles the size of the hash map.
+ * @param[in, out] t - pointer to the table.
+ * @return true, if the map has grown, and false in case of a memory error.
+ */
+static bool grow_map(player_table* t)
+{
+    uint32_t* old_players = t->map_players;
+    uint32_t* old_records = t->map_records;
+    uint64_t old_capacity = t->map_capacity;
+    uint32_t* new_players = calloc(2 * old_capacity, sizeof(uint32_t));
+    uint32_t* new_records = malloc(2 * old_capacity * sizeof(uint32_t));
+    if(new_players == NULL || new_records == NULL)
+    {
+        free(new_players);
+        free(new_records);
+        return false;
+    }
+    t->map_players = new_players;
+    t->map_records = new_records;
+    t->map_capacity = 2 * old_capacity;
+    for(uint64_t i = 0; i < old_capacity; i++)
+    {
+        if(old_players[i] != 0) map_insert(t, old_players[i], old_records[i]);
+    }
+    free(old_players);
+    free(old_records);
+    return true;
+}
+
+bool player_table_init(player_table* t, uint32_t players)
+{
+    t->map_players = NULL;
+    t->map_records = NULL;
+    t->map_capacity = 0;
+    if(players < LAZY_PLAYERS_FROM)
+    {
+        uint64_t n = (uint64_t) players + 1; // record 0 is unused, so that players index the arrays
+        void* block = calloc(1, table_bytes(n));
+        if(block == NULL) return false;
+        carve(t, block, n);
+        t->count = n;
+        return true;
+    }
+    void* block = calloc(1, table_bytes(INITIAL_CAPACITY));
+    t->map_players = calloc(2 * INITIAL_CAPACITY, sizeof(uint32_t));
+    t->map_records = malloc(2 * INITIAL_CAPACITY * sizeof(uint32_t));
+    if(block == NULL || t->map_players == NULL || t->map_records == NULL)
+    {
+        free(block);
+        free(t->map_players);
+        free(t->map_records);
+        t->block = NULL;
+        return false;
+    }
+    carve(t, block, INITIAL_CAPACITY);
+    t->map_capacity = 2 * INITIAL_CAPACITY;
+    t->count = 1; // record 0 stays empty, it is shared by the players without a record
+    return true;
+}
+
+void player_table_free(player_table* t)
+{
+    if(t->block == NULL) return;
+    for(uint64_t r = 1; r < t->count; r++)
+    {
+        free(t->fields[r]);
+        free(t->areas[r]);
+    }
+    free(t->block);
+    free(t->map_players);
+    free(t->map_records);
+    t->block = NULL;
+    t->map_players = NULL;
+    t->map_records = NULL;
+}
+
+uint32_t player_table_find(const player_table* t, uint32_t player)
+{
+    uint64_t i = map_start(t, player);
+    while(t->map_players[i] != player)
+    {
+        if(t->map_players[i] == 0) return 0;
+        i = (i + 1) & (t->map_capacity - 1);
+    }
+    return t->map_records[i];
+}
+
+uint32_t player_table_add(player_table* t, uint32_t player)
+{
+    if(t->map_players == NULL) return player;
+    uint32_t record = player_table_find(t, player);
+    if(record != 0) return record;
+    if(t->count == t->capacity && !grow_records(t)) return 0;
+    if(2 * (t->count + 1) > t->map_capacity && !grow_map(t)) return 0;
+    record = t->count++;
+    map_insert(t, player, record);
+    return record;
+}
+
+bool player_flag(const uint64_t* flags, uint32_t record)
+{
+    return (flags[record / 64] >> (record % 64)) & 1;
+}
+
+void set_player_flag(uint64_t* flags, uint32_t record, bool value)
+{
+    if(value) flags[record / 64] |= (uint64_t) 1 << (record % 64);
+    else flags[record / 64] &= ~((uint64_t) 1 << (record % 64));
+}
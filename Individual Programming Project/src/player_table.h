@@ -0,0 +1,61 @@
+/** @file
+ * Interface of the table of the players of a game. The table stores every piece of data
+ * of the players in a separate array, so that a loop over the players reads only the arrays
+ * it needs, one after another. If there are few players, the arrays are indexed by the player
+ * number. Otherwise a player gets a record only on their first move, and the hash map
+ * of the table gives the number of the record, so the memory used depends only on the number
+ * of players who have moved.
+ */
+
+#ifndef PLAYER_TABLE_H
+#define PLAYER_TABLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "auxiliary_structs.h"
+
+/** Initializes the table with all the players having no fields, no areas
+ * and the golden move not performed.
+ * @param[out] t - pointer to the initialized table,
+ * @param[in] players - number of players, positive integer.
+ * @return true, if the initialization succeeded, and false in case of a memory error.
+ */
+bool player_table_init(player_table* t, uint32_t players);
+
+/** Frees the memory used by the table, including the indices of the fields and the lists
+ * of the areas of the players.
+ * @param[in, out] t - pointer to the table.
+ */
+void player_table_free(player_table* t);
+
+/** Finds the record of a player in the hash map of the table, which must have one.
+ * @param[in] t - pointer to the table,
+ * @param[in] player - player number, positive integer.
+ * @return The number of the record of the player, or 0, if the player has none yet.
+ *         Record 0 stays empty, as the record of a player who has not moved.
+ */
+uint32_t player_table_find(const player_table* t, uint32_t player);
+
+/** Returns the number of the record of a player, creating an empty record,
+ * if the player has none yet.
+ * @param[in, out] t - pointer to the table,
+ * @param[in] player - player number, positive integer.
+ * @return The number of the record, or 0 in case of a memory error.
+ */
+uint32_t player_table_add(player_table* t, uint32_t player);
+
+/** Reads the flag of a player from one of the bitsets of the table.
+ * @param[in] flags - the bitset,
+ * @param[in] record - number of the record of the player.
+ * @return The value of the flag.
+ */
+bool player_flag(const uint64_t* flags, uint32_t record);
+
+/** Sets the flag of a player in one of the bitsets of the table.
+ * @param[in, out] flags - the bitset,
+ * @param[in] record - number of the record of the player,
+ * @param[in] value - the new value of the flag.
+ */
+void set_player_flag(uint64_t* flags, uint32_t record, bool value);
+
+#endif // PLAYER_TABLE_H
@@ -0,0 +1,97 @@
+/** @file
+ * Implementation of the tiled arrays storing the state of the fields of the board.
+ */
+
+#include <stdlib.h>
+
+#include "tiled_array.h"
+
+/** Tile of zeros, which the tiles not allocated yet point to. It is never written to.
+ */
+static uint64_t zero_tile[TILE_FIELDS / 2];
+
+/** Returns the number of bytes of one tile.
+ * @param[in] a - pointer to the array.
+ * @return The number of bytes of one tile.
+ */
+static uint64_t tile_bytes(tiled_array* a)
+{
+    return TILE_FIELDS / 8 * a->field_bits;
+}
+
+bool tiled_array_init(tiled_array* a, uint64_t size, unsigned int field_bits, bool sparse)
+{
+    a->field_bits = field_bits;
+    a->n_of_tiles = (size >> TILE_SHIFT) + 1;
+    a->block = NULL;
+    a->borrowed = false;
+    a->tiles = NULL;
+    if(a->n_of_tiles > SIZE_MAX / sizeof(void*)) return false;
+    a->tiles = malloc(a->n_of_tiles * sizeof(void*));
+    if(a->tiles == NULL) return false;
+    if(sparse)
+    {
+        for(uint64_t t = 0; t < a->n_of_tiles; t++) a->tiles[t] = zero_tile;
+        return true;
+    }
+    a->block = calloc(size / 64 + 1, 8 * field_bits);
+    if(a->block == NULL)
+    {
+        tiled_array_free(a);
+        return false;
+    }
+    for(uint64_t t = 0; t < a->n_of_tiles; t++) a->tiles[t] = (uint8_t*) a->block + t * tile_bytes(a);
+    return true;
+}
+
+uint64_t tiled_array_bytes(uint64_t size, unsigned int field_bits)
+{
+    uint64_t words = size / 64 + 1;
+    if(words > UINT64_MAX / (8 * field_bits)) return 0;
+    return words * 8 * field_bits;
+}
+
+bool tiled_array_init_in(tiled_array* a, uint64_t size, unsigned int field_bits, void* block)
+{
+    a->field_bits = field_bits;
+    a->n_of_tiles = (size >> TILE_SHIFT) + 1;
+    a->block = block;
+    a->borrowed = true;
+    a->tiles = NULL;
+    if(a->n_of_tiles > SIZE_MAX / sizeof(void*)) return false;
+    a->tiles = malloc(a->n_of_tiles * sizeof(void*));
+    if(a->tiles == NULL) return false;
+    for(uint64_t t = 0; t < a->n_of_tiles; t++) a->tiles[t] = (uint8_t*) a->block + t * tile_bytes(a);
+    return true;
+}
+
+void tiled_array_free(tiled_array* a)
+{
+    if(a->tiles != NULL && a->block == NULL)
+    {
+        for(uint64_t t = 0; t < a->n_of_tiles; t++)
+        {
+            if(a->tiles[t] != zero_tile) free(a->tiles[t]);
+        }
+    }
+    free(a->tiles);
+    if(!a->borrowed) free(a->block);
+    a->tiles = NULL;
+    a->block = NULL;
+    a->n_of_tiles = 0;
+}
+
+bool tiled_array_allocated(const tiled_array* a, uint64_t i)
+{
+    return a->tiles[i >> TILE_SHIFT] != zero_tile;
+}
+
+bool tiled_array_reserve(tiled_array* a, uint64_t i)
+{
+    void** tile = &a->tiles[i >> TILE_SHIFT];
+    if(*tile != zero_tile) return true;
+    void* allocated = calloc(1, tile_bytes(a));
+    if(allocated == NULL) return false;
+    *tile = allocated;
+    return true;
+}
@@ -0,0 +1,74 @@
+/** @file
+ * Interface of the tiled arrays storing the state of the fields of the board.
+ * The fields are split into tiles of @ref TILE_FIELDS consecutive indices, and the array keeps
+ * a directory with a pointer to every tile. The tiles may be allocated all at once, in one block,
+ * or each of them on the first write, with the tiles not allocated yet pointing to a shared tile
+ * of zeros. Reading a field costs the same in both cases.
+ */
+
+#ifndef TILED_ARRAY_H
+#define TILED_ARRAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "auxiliary_structs.h"
+
+/** Binary logarithm of the number of fields of one tile.
+ */
+#define TILE_SHIFT 16
+
+/** Number of fields of one tile.
+ */
+#define TILE_FIELDS ((uint64_t) 1 << TILE_SHIFT)
+
+/** Mask of the position of a field within its tile.
+ */
+#define TILE_MASK (TILE_FIELDS - 1)
+
+/** Initializes a tiled array with all the fields equal to zero.
+ * @param[out] a - pointer to the initialized array,
+ * @param[in] size - number of fields, positive integer,
+ * @param[in] field_bits - number of bits of one field: 1, 8, 16 or 32,
+ * @param[in] sparse - true, if the tiles are to be allocated on the first write,
+ *                     and false, if they are to be allocated at once.
+ * @return true, if the initialization succeeded, and false in case of a memory error.
+ */
+bool tiled_array_init(tiled_array* a, uint64_t size, unsigned int field_bits, bool sparse);
+
+/** Returns the number of bytes of the block of a tiled array with all the tiles allocated at once.
+ * @param[in] size - number of fields, positive integer,
+ * @param[in] field_bits - number of bits of one field: 1, 8, 16 or 32.
+ * @return The number of bytes, a multiple of 8, or 0, if it does not fit in 64 bits.
+ */
+uint64_t tiled_array_bytes(uint64_t size, unsigned int field_bits);
+
+/** Initializes a tiled array with the tiles in a given block of memory, which is not freed
+ * together with the array.
+ * @param[out] a - pointer to the initialized array,
+ * @param[in] size - number of fields, positive integer,
+ * @param[in] field_bits - number of bits of one field: 1, 8, 16 or 32,
+ * @param[in] block - memory of @ref tiled_array_bytes bytes, storing the fields.
+ * @return true, if the initialization succeeded, and false in case of a memory error.
+ */
+bool tiled_array_init_in(tiled_array* a, uint64_t size, unsigned int field_bits, void* block);
+
+/** Frees the memory used by the array.
+ * @param[in, out] a - pointer to the array.
+ */
+void tiled_array_free(tiled_array* a);
+
+/** Checks if the tile containing a given field is allocated, and not the shared tile of zeros.
+ * @param[in] a - pointer to the array,
+ * @param[in] i - index of the field.
+ * @return true, if the tile is allocated, and false otherwise.
+ */
+bool tiled_array_allocated(const tiled_array* a, uint64_t i);
+
+/** Makes sure that the tile containing a given field is allocated, so that the field can be written.
+ * @param[in, out] a - pointer to the array,
+ * @param[in] i - index of the field.
+ * @return true, if the tile is allocated, and false in case of a memory error.
+ */
+bool tiled_array_reserve(tiled_array* a, uint64_t i);
+
+#endif // TILED_ARRAY_H
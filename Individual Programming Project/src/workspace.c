@@ -0,0 +1,65 @@
+/** @file
+ * Implementation of the workspaces of the threads.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "workspace.h"
+
+/** The workspace of the thread.
+ */
+static _Thread_local workspace local;
+
+/** True, if the workspace of the thread is going to be freed when the thread exits.
+ */
+static _Thread_local bool registered;
+
+/** Key, whose destructor frees the workspaces of the exiting threads.
+ */
+static pthread_key_t exit_key;
+
+/** True, if @ref exit_key has been created.
+ */
+static bool key_created;
+
+/** Makes sure @ref exit_key is created only once.
+ */
+static pthread_once_t key_once = PTHREAD_ONCE_INIT;
+
+/** Frees the workspace of a thread, which is exiting.
+ * @param[in, out] w - pointer to the workspace.
+ */
+static void free_at_exit(void* w)
+{
+    workspace_free(w);
+}
+
+/** Creates @ref exit_key.
+ */
+static void create_key(void)
+{
+    key_created = pthread_key_create(&exit_key, free_at_exit) == 0;
+}
+
+workspace* workspace_local(void)
+{
+    if(!registered)
+    {
+        pthread_once(&key_once, create_key);
+        registered = key_created && pthread_setspecific(exit_key, &local) == 0;
+    }
+    return &local;
+}
+
+void workspace_free(workspace* w)
+{
+    for(unsigned int i = 0; i < MAX_SEARCHES; i++) free(w->searches[i].fields);
+    free(w->dfs_stack);
+    free(w->dfs_visits);
+    free(w->rows);
+    memset(w, 0, sizeof(workspace));
+}
@@ -0,0 +1,22 @@
+/** @file
+ * Interface of the workspaces of the threads: the scratch memory of the searches and scans
+ * of the areas, shared by all the games played by one thread.
+ */
+
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include "auxiliary_structs.h"
+
+/** Returns the workspace of the calling thread, empty when the thread first asks for it.
+ * Its memory is freed when the thread exits.
+ * @return Pointer to the workspace, valid until the thread exits.
+ */
+workspace* workspace_local(void);
+
+/** Frees the memory of a workspace, leaving it empty, but ready for use.
+ * @param[in, out] w - pointer to the workspace.
+ */
+void workspace_free(workspace* w);
+
+#endif // WORKSPACE_H